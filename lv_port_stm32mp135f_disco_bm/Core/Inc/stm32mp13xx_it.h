@@ -55,6 +55,8 @@ void EXTI14_IRQHandler(void);
 void MDMA_IRQHandler(void);
 void LTDC_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void I2C5_EV_IRQHandler(void);
+void I2C5_ER_IRQHandler(void);
 
 /* USER CODE END EFP */
 
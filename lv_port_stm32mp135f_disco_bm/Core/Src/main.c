@@ -26,6 +26,10 @@
 #include "demos/lv_demos.h"
 #include "lv_port_indev.h"
 #include "lv_port_disp.h"
+#include "lv_port_latency.h"
+#include "lv_port_idle.h"
+#include "lv_port_threadx.h"
+#include "lv_port_defer.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -113,7 +117,7 @@ static void on_benchmark_finished(void)
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-
+  uint32_t wait;
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -153,8 +157,16 @@ int main(void)
   /* USER CODE BEGIN 2 */
   /* Configure LED_RED */
   lv_init();
+  /* work handed from interrupts to the main loop */
+  defer_init();
   disp_init();
   indev_init();
+  /* touch-to-photon tracer, LATENCY_TRACE builds only */
+  latency_init();
+#if !defined(USE_THREADX)
+  /* WFI wake-up alarm for the main loop */
+  idle_init();
+#endif
 
 #if COMPILE_BENCHMARK
 #if LVGL_BENCHMARK_V8
@@ -181,6 +193,10 @@ int main(void)
 #endif
 #if COMPILE_USER_UI
   ui_init();
+#endif
+#if defined(USE_THREADX)
+  /* render and application threads replace the loop below */
+  threadx_start();
 #endif
   /* USER CODE END 2 */
 
@@ -191,8 +207,13 @@ int main(void)
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
-    lv_timer_handler();
-    HAL_Delay(5);
+    /* run LVGL, then sleep until its next deadline or an interrupt */
+    defer_drain();
+    wait = lv_port_indev_process();
+    disp_vsync_process();
+    wait = LV_MIN(wait, lv_timer_handler());
+    defer_drain();
+    idle_wait(wait);
   }
   /* USER CODE END 3 */
 }
@@ -567,24 +588,6 @@ static void UART_Config(void)
     Error_Handler();
   }
 }
-
-#if (LV_TICK_CUSTOM == 1)
-/**
- * Use a custom tick source that tells the elapsed time in milliseconds.
- * It removes the need to manually update the tick with `lv_tick_inc()`
-*/
-uint32_t custom_tick_get(void)
-{
-  static uint32_t start_ms = 0;
-  if(start_ms == 0) {
-    start_ms = HAL_GetTick();
-  }
-  uint32_t now_ms = HAL_GetTick();
-
-  uint32_t time_ms = now_ms - start_ms;
-  return time_ms;
-}
-#endif
 /* USER CODE END 4 */
 
 /**
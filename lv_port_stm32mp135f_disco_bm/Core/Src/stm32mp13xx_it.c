@@ -47,6 +47,7 @@
 extern DMA_HandleTypeDef hdma_memtomem_dma1_stream0;
 extern MDMA_HandleTypeDef hmdma_memtomem;
 extern LTDC_HandleTypeDef hltdc;
+extern I2C_HandleTypeDef hts_i2c;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -165,4 +166,24 @@ void LTDC_IRQHandler(void)
 {
   HAL_LTDC_IRQHandler(&hltdc);
 }
+
+/**
+  * @brief  This function handles I2C5 event interrupt (touchscreen reads).
+  * @param  None
+  * @retval None
+  */
+void I2C5_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hts_i2c);
+}
+
+/**
+  * @brief  This function handles I2C5 error interrupt.
+  * @param  None
+  * @retval None
+  */
+void I2C5_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hts_i2c);
+}
 /* USER CODE END 1 */
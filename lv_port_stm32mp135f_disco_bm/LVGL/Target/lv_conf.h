@@ -39,7 +39,7 @@
  *=========================*/
 
 /*1: use custom malloc/free, 0: use the built-in `lv_mem_alloc()` and `lv_mem_free()`*/
-#define LV_MEM_CUSTOM 0
+#define LV_MEM_CUSTOM 1
 #if LV_MEM_CUSTOM == 0
     /*Size of the memory available for `lv_mem_alloc()` in bytes (>= 2kB)*/
     #define LV_MEM_SIZE (1024 * 1024U)          /*[bytes]*/
@@ -53,10 +53,11 @@
     #endif
 
 #else       /*LV_MEM_CUSTOM*/
-    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
-    #define LV_MEM_CUSTOM_ALLOC   malloc
-    #define LV_MEM_CUSTOM_FREE    free
-    #define LV_MEM_CUSTOM_REALLOC realloc
+    /*TLSF pool in the .lvgl_heap DDR section, see lv_port_mem.c*/
+    #define LV_MEM_CUSTOM_INCLUDE "lv_port_mem.h"   /*Header for the dynamic memory function*/
+    #define LV_MEM_CUSTOM_ALLOC   mem_alloc
+    #define LV_MEM_CUSTOM_FREE    mem_free
+    #define LV_MEM_CUSTOM_REALLOC mem_realloc
 #endif     /*LV_MEM_CUSTOM*/
 
 /*Number of the intermediate memory buffer used during rendering and other internal processing mechanisms.
@@ -89,8 +90,8 @@
 #else
     #define LV_TICK_CUSTOM 1
     #if LV_TICK_CUSTOM
-        #define LV_TICK_CUSTOM_INCLUDE "stdint.h"         /*Header for the system time function*/
-        #define LV_TICK_CUSTOM_SYS_TIME_EXPR (custom_tick_get())    /*Expression evaluating to current system time in ms*/
+        #define LV_TICK_CUSTOM_INCLUDE "lv_port_tick.h"   /*Header for the system time function*/
+        #define LV_TICK_CUSTOM_SYS_TIME_EXPR (tick_get_lvgl())    /*Expression evaluating to current system time in ms*/
     #endif   /*LV_TICK_CUSTOM*/
 #endif       /*__PERF_COUNTER__*/
 
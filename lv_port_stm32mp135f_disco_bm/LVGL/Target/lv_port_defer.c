@@ -0,0 +1,195 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_defer.c
+  * Description        : This file provides a lock-free queue of work posted
+  *                      by interrupts and run by the main loop
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "main.h"
+#include "lv_port_defer.h"
+#include "lv_port_idle.h"
+#include "lv_port_tick.h"
+#include "lv_port_threadx.h"
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* seq == position: free for the producer taking that position,
+ * seq == position + 1: filled, ready for the consumer */
+typedef struct
+{
+  defer_cb_t cb;
+  void * arg;
+#if DEFER_STATS
+  uint32_t posted;          /* tick_get_us() */
+#endif
+  volatile uint32_t seq;
+} item_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if DEFER_STATS
+static void report_timer_cb(lv_timer_t *timer);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static item_t items[DEFER_QUEUE_LEN];
+static volatile uint32_t head;      /* next position to post, producers */
+static uint32_t tail;               /* next position to run, main loop */
+static volatile uint32_t dropped;
+
+#if DEFER_STATS
+/* post-to-run latency, us */
+static uint32_t run_count;
+static uint32_t lat_min = UINT32_MAX;
+static uint32_t lat_max;
+static uint64_t lat_sum;
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void defer_init(void)
+{
+  uint32_t i;
+
+  for(i = 0; i < DEFER_QUEUE_LEN; i++)
+    items[i].seq = i;
+
+#if DEFER_STATS
+  lv_timer_create(report_timer_cb, DEFER_REPORT_MS, NULL);
+#endif
+}
+
+/**
+ * Producers claim a position with LDREX/STREX; an interrupt that posts in
+ * between makes the STREX fail and the claim is retried. The item only
+ * becomes visible to the consumer once its seq is published
+ */
+bool defer_post(defer_cb_t cb, void *arg)
+{
+  uint32_t pos;
+  item_t * item;
+
+  do
+  {
+    pos = __LDREXW((volatile uint32_t *)&head);
+    item = &items[pos & (DEFER_QUEUE_LEN - 1)];
+
+    /* the consumer has not run this slot's previous item yet */
+    if(item->seq != pos)
+    {
+      __CLREX();
+      dropped++;
+      return false;
+    }
+  } while(__STREXW(pos + 1, (volatile uint32_t *)&head));
+
+  __DMB();
+  item->cb = cb;
+  item->arg = arg;
+#if DEFER_STATS
+  item->posted = tick_get_us();
+#endif
+  __DMB();
+  item->seq = pos + 1;
+
+  /* do not let the main loop sleep through it */
+#if defined(USE_THREADX)
+  threadx_signal(THREADX_EVENT_RENDER);
+#else
+  idle_wake();
+#endif
+  return true;
+}
+
+void defer_drain(void)
+{
+  item_t * item;
+  defer_cb_t cb;
+  void * arg;
+#if DEFER_STATS
+  uint32_t latency;
+#endif
+
+  for(;;)
+  {
+    item = &items[tail & (DEFER_QUEUE_LEN - 1)];
+
+    /* claimed but not filled yet: picked up by the next drain */
+    if(item->seq != tail + 1)
+      break;
+
+    __DMB();
+    cb = item->cb;
+    arg = item->arg;
+#if DEFER_STATS
+    latency = tick_get_us() - item->posted;
+#endif
+    __DMB();
+
+    /* hand the slot back for the next lap */
+    item->seq = tail + DEFER_QUEUE_LEN;
+    tail++;
+
+#if DEFER_STATS
+    run_count++;
+    lat_sum += latency;
+    lat_min = LV_MIN(lat_min, latency);
+    lat_max = LV_MAX(lat_max, latency);
+#endif
+
+    cb(arg);
+  }
+}
+
+/**
+ * Print the post-to-run latency on COM1, DEFER_STATS builds only
+ */
+void defer_report(void)
+{
+#if DEFER_STATS
+  if(run_count == 0)
+    return;
+
+  printf("defer n=%lu min=%lu avg=%lu max=%lu us dropped=%lu\r\n",
+         run_count, lat_min, (uint32_t)(lat_sum / run_count), lat_max, dropped);
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if DEFER_STATS
+static void report_timer_cb(lv_timer_t *timer)
+{
+  defer_report();
+}
+#endif
@@ -0,0 +1,71 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_defer.h
+  * Description        : This file provides a lock-free queue of work posted
+  *                      by interrupts and run by the main loop
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_DEFER_H
+#define LV_PORT_DEFER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* must be a power of two */
+#define DEFER_QUEUE_LEN             32
+
+/* 1: print the post-to-run latency on COM1 every DEFER_REPORT_MS */
+#ifndef DEFER_STATS
+#define DEFER_STATS                 0
+#endif
+
+#define DEFER_REPORT_MS             10000
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef void (*defer_cb_t)(void *arg);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void defer_init(void);
+
+/* queue cb(arg) for the main loop; any context, including nested
+ * interrupts. Returns false when the queue is full */
+bool defer_post(defer_cb_t cb, void *arg);
+
+/* run everything posted so far, main loop only */
+void defer_drain(void);
+
+/* no-op unless DEFER_STATS */
+void defer_report(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_DEFER_H*/
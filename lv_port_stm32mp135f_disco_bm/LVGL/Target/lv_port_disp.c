@@ -24,6 +24,12 @@
 #include <assert.h>
 #include "src/misc/lv_assert.h"
 #include "lv_port_disp.h"
+#include "lv_port_indev_filter.h"
+#include "lv_port_latency.h"
+#include "lv_port_threadx.h"
+#include "lv_port_defer.h"
+#include "lv_port_idle.h"
+#include "lv_port_present.h"
 #include "main.h"
 
 /*********************
@@ -53,6 +59,9 @@
 static void disp_clean_dcache(lv_disp_drv_t *drv);
 static void monitor_cb(struct _lv_disp_drv_t * disp_drv, uint32_t time, uint32_t px);
 static void flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color);
+static void wait_cb(lv_disp_drv_t * disp_drv);
+static void flush_done(void *arg);
+static void frame_flushed(void);
 #if (DISP_USE_DMA) && (!BSP_LCD_USE_MDMA)
 static void DMA_TransferComplete(DMA_HandleTypeDef *hdma);
 static void DMA_TransferError(DMA_HandleTypeDef *hdma);
@@ -81,6 +90,8 @@ static uint32_t disp_ysize = 0;
 static volatile bool disp_flush_enabled = true;
 static volatile bool display_enabled = false;
 static volatile bool drawing_allowed = true;
+static volatile bool vsync_armed = false;
+static volatile bool vsync_pending = false;
 #if (DISP_USE_DMA == 1)
 static int32_t x1_flush;
 static int32_t y1_flush;
@@ -110,7 +121,7 @@ static const lv_color_t * buf_to_flush;
 #define LCD_VSYNC_FREQ_HIGH()
 #endif /* VSYNC_FREQ_Pin */
 
-#if defined(FRAME_RATE_Pin)
+#if defined(FRAME_RATE_Pin) && !(LATENCY_TRACE && LATENCY_TRACE_GPIO)
 #define LCD_FRAME_RATE_LOW()                       WRITE_REG(FRAME_RATE_GPIO_Port->BSRR, FRAME_RATE_Pin)
 #define LCD_FRAME_RATE_HIGH()                      WRITE_REG(FRAME_RATE_GPIO_Port->BSRR, (uint32_t)FRAME_RATE_Pin << 16)
 #else
@@ -150,11 +161,30 @@ void BSP_LCD_SignalTearingEffectEvent(uint32_t Instance, uint8_t state, uint16_t
       /* Entering Active Area : de-allow drawing */
       drawing_allowed = false;
       LCD_VSYNC_FREQ_HIGH();
+#if (DISP_VSYNC_REFRESH)
+      present_frame_start();
+
+      /* render into the back buffer while this frame scans out */
+      if (vsync_armed)
+      {
+        vsync_armed = false;
+        vsync_pending = true;
+#if defined(USE_THREADX)
+        threadx_signal(THREADX_EVENT_RENDER);
+#else
+        idle_wake();
+#endif
+      }
+#endif
     }
     else
     {
       /* Exiting Active Area : allow drawing */
+      LATENCY_MARK(LATENCY_VISIBLE);
       drawing_allowed = true;
+#if defined(USE_THREADX)
+      threadx_signal(THREADX_EVENT_VBLANK);
+#endif
       LCD_VSYNC_FREQ_LOW();
     }
   }
@@ -198,7 +228,47 @@ void disp_init(void)
   main_disp_drv.flush_cb = flush_cb;
   main_disp_drv.clean_dcache_cb = disp_clean_dcache;
   main_disp_drv.monitor_cb = monitor_cb;
+  main_disp_drv.wait_cb = wait_cb;
   main_disp = lv_disp_drv_register(&main_disp_drv);
+
+#if (DISP_VSYNC_REFRESH)
+  /* disp_vsync_process() refreshes on the LTDC frame start */
+  lv_timer_set_period(_lv_disp_get_refr_timer(main_disp), DISP_VSYNC_FALLBACK_MS);
+  /* animations are timed to the frame start too */
+  present_init();
+#endif
+}
+
+/*
+ * Render the frame requested by the last frame start, then ask for the next
+ * one if something is left to draw. Call it from the LVGL loop right before
+ * lv_timer_handler()
+ */
+void disp_vsync_process(void)
+{
+#if (DISP_VSYNC_REFRESH)
+  lv_timer_t * timer = _lv_disp_get_refr_timer(main_disp);
+
+  if (vsync_pending)
+  {
+    vsync_pending = false;
+    /* animations at the time this frame is shown, then render it */
+    present_anim_refr();
+    _lv_disp_refr_timer(timer);
+  }
+
+  /* the fallback period starts with the wait for a frame start, not
+   * with the last refresh, which may be long ago */
+  if (!vsync_armed)
+  {
+    lv_timer_reset(timer);
+    lv_timer_reset(lv_anim_get_timer());
+  }
+
+  /* invalidating an area resumes the refresh timer, a running animation
+   * will invalidate at the next frame */
+  vsync_armed = !timer->paused || !lv_anim_get_timer()->paused;
+#endif
 }
 
 /**********************
@@ -213,6 +283,7 @@ static void disp_clean_dcache(lv_disp_drv_t *drv)
 static void flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color)
 {
   LCD_FRAME_RATE_HIGH();
+  LATENCY_MARK(LATENCY_RENDER);
 
   if(!disp_flush_enabled)
   {
@@ -226,14 +297,28 @@ static void flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_
     disp_drv->clean_dcache_cb(disp_drv);
   }
 
-  /* Wait until drawing is allowed */
-  while (display_enabled && !drawing_allowed) { };
+  /* Wait until drawing is allowed, sleeping until the LTDC line event */
+#if defined(USE_THREADX)
+  while (display_enabled && !drawing_allowed)
+    threadx_wait(THREADX_EVENT_VBLANK);
+#else
+  __disable_irq();
+  while (display_enabled && !drawing_allowed)
+  {
+    __DSB();
+    __WFI();
+    __enable_irq();
+    __disable_irq();
+  }
+  __enable_irq();
+#endif
 
   if(disp_drv->full_refresh)
   {
     LTDC_Layer1->CFBAR = (uint32_t)color;
     /* Reload LTDC Configuration */
     LTDC->SRCR = (uint32_t)LTDC_SRCR_IMR;
+    frame_flushed();
     lv_disp_flush_ready(disp_drv);
     LCD_FRAME_RATE_LOW();
   }
@@ -293,12 +378,52 @@ static void flush_cb(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_
         wp += disp_drv->hor_res;
         rp += w;
       }
+      if(lv_disp_flush_is_last(disp_drv))
+        frame_flushed();
       lv_disp_flush_ready(disp_drv);
       LCD_FRAME_RATE_LOW();
     }
   }
 }
 
+/*
+ * LVGL waits for the previous flush: its completion may sit in the deferred
+ * work queue
+ */
+static void wait_cb(lv_disp_drv_t * disp_drv)
+{
+  defer_drain();
+}
+
+/*
+ * End of a DMA flush, deferred from the transfer complete interrupt
+ */
+static void flush_done(void *arg)
+{
+  if(main_disp_drv.clean_dcache_cb)
+  {
+    main_disp_drv.clean_dcache_cb(&main_disp_drv);
+  }
+  /* rotated frames arrive in several areas */
+  if(lv_disp_flush_is_last(&main_disp_drv))
+    frame_flushed();
+  lv_disp_flush_ready(&main_disp_drv);
+  LCD_FRAME_RATE_LOW();
+}
+
+/*
+ * The last area of a frame reached the frame buffer
+ */
+static void frame_flushed(void)
+{
+  LATENCY_MARK(LATENCY_FLUSH);
+  /* the touch filter predicts ahead by the measured latency */
+  indev_filter_presented(HAL_GetTick());
+#if (DISP_VSYNC_REFRESH)
+  present_flushed();
+#endif
+}
+
 /*
  * This callback is used to enable the display only after having the first frame drawn.
  */
@@ -335,12 +460,10 @@ void BSP_LCD_SignalTransferDone(uint32_t Instance)
 
 	if(y_fill_act > y2_flush) {
 	  buf_to_flush = 0;
-	  if(main_disp_drv.clean_dcache_cb)
-	  {
-		main_disp_drv.clean_dcache_cb(&main_disp_drv);
-	  }
-	  lv_disp_flush_ready(&main_disp_drv);
-	  LCD_FRAME_RATE_LOW();
+	  /* whole cache maintenance is too long for the interrupt; with the
+	   * queue full, do it here rather than leave LVGL waiting forever */
+	  if(!defer_post(flush_done, NULL))
+	    flush_done(NULL);
 	}
 	else
 	{
@@ -372,12 +495,10 @@ static void DMA_TransferComplete(DMA_HandleTypeDef *hdma)
 
 	if(y_fill_act > y2_flush) {
 	  buf_to_flush = 0;
-      if(main_disp_drv.clean_dcache_cb)
-      {
-        main_disp_drv.clean_dcache_cb(&main_disp_drv);
-      }
-	  lv_disp_flush_ready(&main_disp_drv);
-	  LCD_FRAME_RATE_LOW();
+	  /* whole cache maintenance is too long for the interrupt; with the
+	   * queue full, do it here rather than leave LVGL waiting forever */
+	  if(!defer_post(flush_done, NULL))
+	    flush_done(NULL);
 	}
 	else
 	{
@@ -37,6 +37,14 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/* 1: render at the start of each LTDC frame instead of on a free-running
+ * timer, 0: every LV_DISP_DEF_REFR_PERIOD */
+#ifndef DISP_VSYNC_REFRESH
+#define DISP_VSYNC_REFRESH                1
+#endif
+
+/* refresh anyway when no frame start came, e.g. before the panel is on */
+#define DISP_VSYNC_FALLBACK_MS            100
 
 /**********************
  *      TYPEDEFS
@@ -48,6 +56,7 @@ extern "C" {
 void disp_init(void);
 void disp_enable_update(void);
 void disp_disable_update(void);
+void disp_vsync_process(void);
 
 /**********************
  * GLOBAL VARIABLES
@@ -0,0 +1,100 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_idle.c
+  * Description        : This file provides the deadline-aware idle wait of
+  *                      the LVGL main loop
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "main.h"
+#include "lv_port_idle.h"
+#include "lv_port_tick.h"
+#include "lv_port_threadx.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* CNTP_CTL: ENABLE, IMASK clear */
+#define TIMER_ARMED                 0x1U
+#define TIMER_STOPPED               0x0U
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static volatile uint8_t wake_pending;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Use the secure physical timer as wake-up alarm. HAL_InitTick() leaves it
+ * without interrupt since the tick is read from the counter
+ */
+void idle_init(void)
+{
+  PL1_SetControl(TIMER_STOPPED);
+
+  IRQ_Disable(SecurePhysicalTimer_IRQn);
+  IRQ_ClearPending(SecurePhysicalTimer_IRQn);
+  IRQ_SetPriority(SecurePhysicalTimer_IRQn, TICK_INT_PRIORITY << 4);
+  IRQ_SetMode(SecurePhysicalTimer_IRQn, IRQ_MODE_TRIG_EDGE);
+  IRQ_Enable(SecurePhysicalTimer_IRQn);
+}
+
+/**
+ * Sleep in WFI for up to ms, or until an interrupt. Returns at once when
+ * idle_wake() was called since the last wait, so an event signalled after
+ * the main loop checked for work is not slept through
+ */
+void idle_wait(uint32_t ms)
+{
+  if(ms == 0)
+    return;
+
+  ms = (ms < IDLE_MAX_SLEEP_MS) ? ms : IDLE_MAX_SLEEP_MS;
+
+  /* a pending interrupt ends WFI even while masked */
+  __disable_irq();
+
+  if(!wake_pending)
+  {
+    PL1_SetLoadValue(ms * (tick_get_freq() / 1000UL));
+    PL1_SetControl(TIMER_ARMED);
+    __DSB();
+    __WFI();
+
+    /* the alarm handler reloads the timer for the 1 ms HAL tick */
+    PL1_SetControl(TIMER_STOPPED);
+  }
+  wake_pending = 0;
+
+  __enable_irq();
+}
+
+/**
+ * Signal work for the main loop. Interrupt context
+ */
+void idle_wake(void)
+{
+#if defined(USE_THREADX)
+  threadx_signal(THREADX_EVENT_INPUT);
+#else
+  wake_pending = 1;
+#endif
+}
@@ -0,0 +1,50 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_idle.h
+  * Description        : This file provides the deadline-aware idle wait of
+  *                      the LVGL main loop
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_IDLE_H
+#define LV_PORT_IDLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* longest single sleep, also used when LVGL has no timer ready */
+#define IDLE_MAX_SLEEP_MS           1000
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void idle_init(void);
+void idle_wait(uint32_t ms);
+void idle_wake(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_IDLE_H*/
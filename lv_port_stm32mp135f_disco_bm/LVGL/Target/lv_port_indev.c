@@ -24,28 +24,74 @@
 #include "main.h"
 #include "src/misc/lv_assert.h"
 #include "lv_port_indev.h"
+#include "lv_port_indev_filter.h"
+#include "lv_port_latency.h"
+#include "lv_port_record.h"
+#include "lv_port_idle.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define TS_INSTANCE		(0)
+
+/* must be a power of two */
+#define TS_QUEUE_LEN		(16)
+
+/* the GT911 reports every ~10 ms while touched; give up on a missed
+ * release report after this long */
+#define TS_RELEASE_MS		(100)
+
+/* status register followed by 8 bytes per touch point */
+#define TS_POINT_SIZE		(8)
+#define TS_BURST_SIZE		(1 + GT911_MAX_NB_TOUCH * TS_POINT_SIZE)
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+  int16_t x;
+  int16_t y;
+  lv_indev_state_t state;
+  uint8_t points;       /* touch points in the report */
+  uint32_t timestamp;   /* HAL_GetTick() at the TS_INT edge */
+} ts_event_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void indev_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+static void ts_i2c_init(void);
+static void ts_read_start(void);
+static void ts_exti_callback(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static TS_Init_t hTS;
-static TS_State_t  TS_State;
 static lv_indev_drv_t indev_drv;                /*Descriptor of an input device driver*/
+static lv_indev_t * indev;
 static int16_t last_x = 0;
 static int16_t last_y = 0;
+static uint32_t max_x, max_y;
+
+/* single producer (I2C interrupt), single consumer (main loop) */
+static ts_event_t ts_queue[TS_QUEUE_LEN];
+static volatile uint32_t q_head;
+static volatile uint32_t q_tail;
+static volatile uint32_t q_dropped;
+
+static uint8_t ts_rx[TS_BURST_SIZE];
+static uint8_t ts_status_clear = 0;
+static volatile uint8_t read_again;
+static volatile uint32_t irq_timestamp;
+static uint32_t last_timestamp;
+static uint8_t pressed;
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+/* I2C5 once the BSP has set it up; only the touch controller sits on it */
+I2C_HandleTypeDef hts_i2c;
 
 /**********************
  *      MACROS
@@ -71,6 +117,7 @@ void indev_init(void)
   int32_t ret;
   uint32_t x_size, y_size;
   uint8_t iterations = 10;
+  TS_Capabilities_t caps;
 
   BSP_LCD_GetXSize(0, &x_size);
   BSP_LCD_GetYSize(0, &y_size);
@@ -87,11 +134,162 @@ void indev_init(void)
   } while ((ret != BSP_ERROR_NONE) && (iterations-- > 0));
   lv_port_indev_assert((ret == BSP_ERROR_NONE) && "failed to initialize TouchScreen");
 
+  BSP_TS_GetCapabilities(TS_INSTANCE, &caps);
+  max_x = caps.MaxXl;
+  max_y = caps.MaxYl;
+
   lv_indev_drv_init(&indev_drv);                  /*Basic initialization*/
   indev_drv.type = LV_INDEV_TYPE_POINTER;         /*The touchpad is pointer type device*/
   indev_drv.read_cb = indev_read;
 
-  lv_indev_drv_register(&indev_drv);
+  indev = lv_indev_drv_register(&indev_drv);
+
+  /* read on demand from lv_port_indev_process(), not by timer, except
+   * while LVGL needs periodic reads (see there) */
+  lv_timer_pause(indev->driver->read_timer);
+
+  ts_i2c_init();
+
+  ret = BSP_TS_EnableIT(TS_INSTANCE);
+  lv_port_indev_assert((ret == BSP_ERROR_NONE) && "failed to enable TouchScreen interrupt");
+
+  /* the GT911 pulses INT high once per report: one edge is enough, and the
+   * BSP callback would clear the status over I2C inside the interrupt */
+  GPIO_InitTypeDef gpio_init_structure = {0};
+  gpio_init_structure.Pin   = TS_INT_PIN;
+  gpio_init_structure.Pull  = GPIO_PULLDOWN;
+  gpio_init_structure.Speed = GPIO_SPEED_FREQ_HIGH;
+  gpio_init_structure.Mode  = GPIO_MODE_IT_RISING;
+  HAL_GPIO_Init(TS_INT_GPIO_PORT, &gpio_init_structure);
+  HAL_EXTI_RegisterCallback(&hts_exti[TS_INSTANCE], HAL_EXTI_COMMON_CB_ID, ts_exti_callback);
+}
+
+/**
+ * Feed queued events to LVGL. No I2C traffic happens here.
+ * Call from the main loop, before lv_timer_handler()
+ * @return ms until it needs to run again without new reports
+ */
+uint32_t lv_port_indev_process(void)
+{
+  uint32_t wait = LV_NO_TIMER_READY;
+  uint32_t elapsed;
+
+  if((q_head != q_tail) || replay_pending())
+  {
+    lv_indev_read_timer_cb(indev->driver->read_timer);
+  }
+
+  /* queue drained with a retry still flagged and the bus idle: no I2C
+   * completion is coming to run it, start it from here. TS_INT starts
+   * reads too, and the HAL lock does not hold against an interrupt */
+  if(read_again && (q_head == q_tail))
+  {
+    IRQ_Disable(TS_INT_EXTI_IRQn);
+    if(read_again && (HAL_I2C_GetState(&hts_i2c) == HAL_I2C_STATE_READY))
+    {
+      irq_timestamp = HAL_GetTick();
+      ts_read_start();
+    }
+    IRQ_Enable(TS_INT_EXTI_IRQn);
+  }
+
+  if(pressed && (HAL_GetTick() - last_timestamp) > TS_RELEASE_MS)
+  {
+    pressed = 0;
+    lv_indev_read_timer_cb(indev->driver->read_timer);
+  }
+
+  /* LVGL v8 runs long-press repeat and scroll throw from the read timer:
+   * keep it running while pressed and until a throw has come to rest */
+  if(pressed || lv_indev_get_scroll_obj(indev) != NULL)
+    lv_timer_resume(indev->driver->read_timer);
+  else
+    lv_timer_pause(indev->driver->read_timer);
+
+  /* the release fallback needs a look once the reports stop */
+  if(pressed)
+  {
+    elapsed = HAL_GetTick() - last_timestamp;
+    wait = (elapsed > TS_RELEASE_MS) ? 0 : TS_RELEASE_MS + 1 - elapsed;
+  }
+
+  return LV_MIN(wait, replay_wait());
+}
+
+/**
+ * Report read: status and all points arrived in one burst
+ */
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  uint32_t head = q_head;
+  uint8_t status = ts_rx[0];
+  uint8_t points = status & GT911_TD_STATUS_BITS_NBTOUCHPTS;
+  ts_event_t * ev;
+
+  if(hi2c != &hts_i2c)
+    return;
+
+  /* not a fresh report, nothing to acknowledge; no status write follows
+   * to retry from, so pick up a report that came in meanwhile here */
+  if(!(status & GT911_TD_STATUS_BIT_BUFFER_STAT) || points > GT911_MAX_NB_TOUCH)
+  {
+    if(read_again)
+      ts_read_start();
+    return;
+  }
+
+  /* let the controller refill its buffer while we decode this one */
+  HAL_I2C_Mem_Write_IT(&hts_i2c, TS_I2C_ADDRESS, GT911_TD_STAT_REG, I2C_MEMADD_SIZE_16BIT,
+                       &ts_status_clear, 1);
+
+  if(head - q_tail == TS_QUEUE_LEN)
+  {
+    q_dropped++;
+    return;
+  }
+
+  /* LVGL v8 pointers are single touch: queue the first point */
+  ev = &ts_queue[head & (TS_QUEUE_LEN - 1)];
+  ev->points = points;
+  ev->timestamp = irq_timestamp;
+  if(points)
+  {
+    ev->x = ((ts_rx[3] << 8) | ts_rx[2]) * hTS.Width / max_x;
+    ev->y = ((ts_rx[5] << 8) | ts_rx[4]) * hTS.Height / max_y;
+    ev->state = LV_INDEV_STATE_PRESSED;
+  }
+  else
+  {
+    ev->state = LV_INDEV_STATE_RELEASED;
+  }
+
+  __DMB();
+  q_head = head + 1;
+
+  idle_wake();
+}
+
+/**
+ * Status cleared: pick up a report that came in meanwhile
+ */
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  if(hi2c != &hts_i2c)
+    return;
+
+  if(read_again)
+    ts_read_start();
+}
+
+/**
+ * A NACK or bus error drops the report; the next INT retries
+ */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if(hi2c != &hts_i2c)
+    return;
+
+  read_again = 0;
 }
 
 /**********************
@@ -105,23 +303,103 @@ void indev_init(void)
  * @param y put the y coordinate here
  * @return true: the device is pressed, false: released
  */
-static void indev_read(lv_indev_drv_t *indev, lv_indev_data_t *data)
+static void indev_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
 {
-  /* Read your touchpad */
-  BSP_TS_GetState(TS_INSTANCE, &TS_State);  /*Get touch state*/
+  uint32_t tail = q_tail;
 
-  if(TS_State.TouchDetected)
+  /* the panel is ignored while a recording plays back */
+  if(replay_read(data))
   {
-    data->point.x = TS_State.TouchX;
-    data->point.y = TS_State.TouchY;
-    last_x = data->point.x;
-    last_y = data->point.y;
-    data->state = LV_INDEV_STATE_PRESSED;
+    q_tail = q_head;
+    pressed = 0;
+    return;
   }
-  else
+
+  if(tail == q_head)
   {
     data->point.x = last_x;
     data->point.y = last_y;
-    data->state = LV_INDEV_STATE_RELEASED;
+    data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    record_read(data);
+    return;
+  }
+
+  /* one queued event per call, LVGL calls again while continue_reading */
+  const ts_event_t * ev = &ts_queue[tail & (TS_QUEUE_LEN - 1)];
+  if(ev->state == LV_INDEV_STATE_PRESSED)
+  {
+    LATENCY_MARK(LATENCY_READ);
+    if(!pressed)
+      indev_filter_reset();
+    last_x = ev->x;
+    last_y = ev->y;
+    indev_filter_apply(&last_x, &last_y, ev->timestamp);
   }
+  data->point.x = last_x;
+  data->point.y = last_y;
+  data->state = ev->state;
+  last_timestamp = ev->timestamp;
+  pressed = (ev->state == LV_INDEV_STATE_PRESSED);
+
+  __DMB();
+  q_tail = tail + 1;
+  data->continue_reading = (q_tail != q_head);
+
+  record_read(data);
+}
+
+/**
+ * Take over I2C5 from the BSP with the same timing, for interrupt transfers.
+ * BSP_TS_* calls that touch the bus must not be used from here on.
+ */
+static void ts_i2c_init(void)
+{
+  uint32_t dnf = (BUS_I2C5_INSTANCE->CR1 & I2C_CR1_DNF) >> I2C_CR1_DNF_Pos;
+
+  hts_i2c.Instance              = BUS_I2C5_INSTANCE;
+  hts_i2c.Init.Timing           = BUS_I2C5_INSTANCE->TIMINGR;
+  hts_i2c.Init.OwnAddress1      = 0;
+  hts_i2c.Init.AddressingMode   = I2C_ADDRESSINGMODE_7BIT;
+  hts_i2c.Init.DualAddressMode  = I2C_DUALADDRESS_DISABLE;
+  hts_i2c.Init.OwnAddress2      = 0;
+  hts_i2c.Init.OwnAddress2Masks = I2C_OA2_NOMASK;
+  hts_i2c.Init.GeneralCallMode  = I2C_GENERALCALL_DISABLE;
+  hts_i2c.Init.NoStretchMode    = I2C_NOSTRETCH_DISABLE;
+
+  if((HAL_I2C_Init(&hts_i2c) != HAL_OK) ||
+     (HAL_I2CEx_ConfigAnalogFilter(&hts_i2c, I2C_ANALOGFILTER_ENABLE) != HAL_OK) ||
+     (HAL_I2CEx_ConfigDigitalFilter(&hts_i2c, dnf) != HAL_OK))
+  {
+    Error_Handler();
+  }
+
+  /* same priority as TS_INT: the EXTI and I2C handlers never preempt each other */
+  IRQ_SetPriority(I2C5_EV_IRQn, 0x00);
+  IRQ_Enable(I2C5_EV_IRQn);
+  IRQ_SetPriority(I2C5_ER_IRQn, 0x00);
+  IRQ_Enable(I2C5_ER_IRQn);
+}
+
+/**
+ * Status register and all five points in a single transfer
+ */
+static void ts_read_start(void)
+{
+  read_again = 0;
+  if(HAL_I2C_Mem_Read_IT(&hts_i2c, TS_I2C_ADDRESS, GT911_TD_STAT_REG, I2C_MEMADD_SIZE_16BIT,
+                         ts_rx, TS_BURST_SIZE) != HAL_OK)
+  {
+    /* bus still busy clearing the previous report */
+    read_again = 1;
+  }
+}
+
+/**
+ * TS_INT rising edge: a new report is ready in the GT911
+ */
+static void ts_exti_callback(void)
+{
+  LATENCY_MARK(LATENCY_TOUCH);
+  irq_timestamp = HAL_GetTick();
+  ts_read_start();
 }
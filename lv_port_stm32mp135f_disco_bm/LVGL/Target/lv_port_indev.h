@@ -46,6 +46,7 @@ extern "C" {
  * GLOBAL PROTOTYPES
  **********************/
 void indev_init(void);
+uint32_t lv_port_indev_process(void);
 
 /**********************
  * GLOBAL VARIABLES
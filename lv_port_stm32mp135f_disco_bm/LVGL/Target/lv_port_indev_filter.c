@@ -0,0 +1,176 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_indev_filter.c
+  * Description        : This file provides a latency compensating touch filter
+  *                      for the LVGL input device port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <math.h>
+#include "lv_port_indev_filter.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PI_F                (3.14159265f)
+
+/* latency average weight 1/8 */
+#define LATENCY_AVG         (8)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+  float value;      /* filtered position, px */
+  float speed;      /* filtered velocity, px/s */
+} one_euro_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void one_euro(one_euro_t *f, float x, float dt);
+static float smoothing(float cutoff, float dt);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static bool enabled = INDEV_FILTER;
+static bool started;
+static uint32_t prev_timestamp;
+static one_euro_t fx;
+static one_euro_t fy;
+
+static uint32_t sample_timestamp;
+static bool sample_pending;
+static uint32_t latency = INDEV_FILTER_SCANOUT_MS;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Start of a new touch: forget the previous trajectory
+ */
+void indev_filter_reset(void)
+{
+  started = false;
+}
+
+/**
+ * Filter a pressed sample in place
+ * @param timestamp HAL_GetTick() at the touch interrupt
+ */
+void indev_filter_apply(int16_t *x, int16_t *y, uint32_t timestamp)
+{
+  lv_disp_t * disp = lv_disp_get_default();
+  float dt;
+  int32_t px, py;
+
+  sample_timestamp = timestamp;
+  sample_pending = true;
+
+  if(!enabled)
+    return;
+
+  if(!started)
+  {
+    fx.value = *x;
+    fy.value = *y;
+    fx.speed = fy.speed = 0.0f;
+    prev_timestamp = timestamp;
+    started = true;
+    return;
+  }
+
+  /* several reports can share a tick when drained from the queue */
+  dt = LV_MAX(timestamp - prev_timestamp, 1) / 1000.0f;
+  prev_timestamp = timestamp;
+
+  one_euro(&fx, *x, dt);
+  one_euro(&fy, *y, dt);
+
+#if INDEV_FILTER_PREDICT
+  float horizon = LV_MIN(latency, INDEV_FILTER_PREDICT_MAX_MS) / 1000.0f;
+  px = lroundf(fx.value + fx.speed * horizon);
+  py = lroundf(fy.value + fy.speed * horizon);
+#else
+  px = lroundf(fx.value);
+  py = lroundf(fy.value);
+#endif
+
+  *x = LV_CLAMP(0, px, lv_disp_get_hor_res(disp) - 1);
+  *y = LV_CLAMP(0, py, lv_disp_get_ver_res(disp) - 1);
+}
+
+/**
+ * A frame containing the last applied sample was handed to the LTDC
+ */
+void indev_filter_presented(uint32_t now)
+{
+  /* only the first frame after a sample shows it */
+  if(!sample_pending)
+    return;
+  sample_pending = false;
+
+  uint32_t measured = now - sample_timestamp + INDEV_FILTER_SCANOUT_MS;
+  latency = (latency * (LATENCY_AVG - 1) + measured) / LATENCY_AVG;
+}
+
+/**
+ * Runtime switch, starts as INDEV_FILTER
+ */
+void indev_filter_enable(bool enable)
+{
+  enabled = enable;
+  started = false;
+}
+
+/**
+ * Averaged touch-to-display latency in ms
+ */
+uint32_t indev_filter_get_latency(void)
+{
+  return latency;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void one_euro(one_euro_t *f, float x, float dt)
+{
+  float speed = (x - f->value) / dt;
+  float cutoff;
+
+  f->speed += smoothing(INDEV_FILTER_D_CUTOFF, dt) * (speed - f->speed);
+
+  /* slow: heavy smoothing against jitter, fast: follow the finger */
+  cutoff = INDEV_FILTER_MIN_CUTOFF + INDEV_FILTER_BETA * fabsf(f->speed);
+  f->value += smoothing(cutoff, dt) * (x - f->value);
+}
+
+/**
+ * Exponential smoothing factor of a first order low-pass
+ */
+static float smoothing(float cutoff, float dt)
+{
+  float tau = 1.0f / (2.0f * PI_F * cutoff);
+
+  return 1.0f / (1.0f + tau / dt);
+}
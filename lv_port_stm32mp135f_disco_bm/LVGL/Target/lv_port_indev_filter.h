@@ -0,0 +1,76 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_indev_filter.h
+  * Description        : This file provides a latency compensating touch filter
+  *                      for the LVGL input device port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_INDEV_FILTER_H
+#define LV_PORT_INDEV_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/* 1: smooth the samples, 0 (default): LVGL gets the raw samples */
+#ifndef INDEV_FILTER
+#define INDEV_FILTER                  0
+#endif
+
+/* One Euro filter: a low-pass whose cutoff rises with the finger speed.
+ * Lower MIN_CUTOFF for less jitter at rest, raise BETA for less lag on
+ * fast drags; D_CUTOFF smooths the speed estimate itself */
+#define INDEV_FILTER_MIN_CUTOFF       1.0f      /* Hz */
+#define INDEV_FILTER_BETA             0.02f
+#define INDEV_FILTER_D_CUTOFF         1.0f      /* Hz */
+
+/* the filtered point is extrapolated along the filtered velocity by the
+ * measured touch-to-display latency, up to this horizon */
+#ifndef INDEV_FILTER_PREDICT
+#define INDEV_FILTER_PREDICT          0
+#endif
+#define INDEV_FILTER_PREDICT_MAX_MS   48
+
+/* added to the measured latency: the frame buffer address is reloaded
+ * immediately, half a scan-out at ~60 Hz on average until it is seen */
+#define INDEV_FILTER_SCANOUT_MS       8
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void indev_filter_reset(void);
+void indev_filter_apply(int16_t *x, int16_t *y, uint32_t timestamp);
+void indev_filter_presented(uint32_t now);
+void indev_filter_enable(bool enable);
+uint32_t indev_filter_get_latency(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_INDEV_FILTER_H*/
@@ -0,0 +1,205 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_latency.c
+  * Description        : This file provides a touch-to-photon latency tracer
+  *                      for the LVGL port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "main.h"
+#include "lv_port_latency.h"
+
+#if LATENCY_TRACE
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LATENCY_TRACE_GPIO && defined(FRAME_RATE_Pin)
+#define LATENCY_PIN_HIGH()      WRITE_REG(FRAME_RATE_GPIO_Port->BSRR, FRAME_RATE_Pin)
+#define LATENCY_PIN_LOW()       WRITE_REG(FRAME_RATE_GPIO_Port->BSRR, (uint32_t)FRAME_RATE_Pin << 16)
+#else
+#define LATENCY_PIN_HIGH()
+#define LATENCY_PIN_LOW()
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+  uint32_t bins[LATENCY_BINS];
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} histogram_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void record(histogram_t *h, uint32_t us);
+static void report_timer_cb(lv_timer_t *timer);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* [0] touch to visible, [n] stage n-1 to stage n */
+static const char * const names[LATENCY_STAGES] = {
+  "total", "touch>read", "read>render", "render>flush", "flush>visible"
+};
+
+static histogram_t hist[LATENCY_STAGES];
+static uint64_t stamp[LATENCY_STAGES];
+static volatile latency_stage_t next;
+static uint32_t ticks_per_us;
+static uint32_t reported;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Set up the time base and the periodic report
+ */
+void latency_init(void)
+{
+  uint32_t i;
+
+  /* the generic timer counts at the STGEN clock, as in HAL_GetTick() */
+  if((RCC->STGENCKSELR & RCC_STGENCKSELR_STGENSRC) == RCC_STGENCLKSOURCE_HSE)
+    ticks_per_us = HSE_VALUE / 1000000UL;
+  else
+    ticks_per_us = HSI_VALUE / 1000000UL;
+
+  for(i = 0; i < LATENCY_STAGES; i++)
+    hist[i].min = UINT32_MAX;
+  next = LATENCY_TOUCH;
+
+  lv_timer_create(report_timer_cb, LATENCY_REPORT_MS, NULL);
+}
+
+/**
+ * Timestamp a stage; stages are only taken in order, one touch at a time.
+ * Main loop or interrupt context
+ */
+void latency_mark(latency_stage_t stage)
+{
+  uint32_t cpsr = __get_CPSR();
+  uint64_t now = PL1_GetCurrentPhysicalValue();
+  uint32_t i;
+
+  __disable_irq();
+
+  /* a new trace starts on a touch when idle or when the last one stalled,
+   * e.g. the touch did not change any pixel */
+  if(stage == LATENCY_TOUCH)
+  {
+    if((next == LATENCY_TOUCH) ||
+       (now - stamp[LATENCY_TOUCH] > (uint64_t)LATENCY_TIMEOUT_MS * 1000 * ticks_per_us))
+    {
+      stamp[LATENCY_TOUCH] = now;
+      next = LATENCY_READ;
+      LATENCY_PIN_HIGH();
+    }
+  }
+  else if(stage == next)
+  {
+    stamp[stage] = now;
+
+    if(stage == LATENCY_VISIBLE)
+    {
+      LATENCY_PIN_LOW();
+      record(&hist[0], (now - stamp[LATENCY_TOUCH]) / ticks_per_us);
+      for(i = 1; i < LATENCY_STAGES; i++)
+        record(&hist[i], (stamp[i] - stamp[i - 1]) / ticks_per_us);
+      next = LATENCY_TOUCH;
+    }
+    else
+    {
+      next = stage + 1;
+    }
+  }
+
+  /* restore the I bit as it was */
+  if(!(cpsr & 0x80U))
+    __enable_irq();
+}
+
+/**
+ * Print the histograms on COM1, also done every LATENCY_REPORT_MS
+ */
+void latency_report(void)
+{
+  uint32_t i, b;
+
+  for(i = 0; i < LATENCY_STAGES; i++)
+  {
+    histogram_t * h = &hist[i];
+
+    if(h->count == 0)
+      continue;
+
+    printf("latency %s n=%lu min=%lu avg=%lu max=%lu us\r\n",
+           names[i], h->count, h->min, (uint32_t)(h->sum / h->count), h->max);
+
+    /* one count per ms bin */
+    for(b = 0; b < LATENCY_BINS; b++)
+      printf(b ? ",%lu" : "%lu", h->bins[b]);
+    printf("\r\n");
+  }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void record(histogram_t *h, uint32_t us)
+{
+  h->bins[LV_MIN(us / LATENCY_BIN_US, LATENCY_BINS - 1)]++;
+  h->count++;
+  h->sum += us;
+  h->min = LV_MIN(h->min, us);
+  h->max = LV_MAX(h->max, us);
+}
+
+static void report_timer_cb(lv_timer_t *timer)
+{
+  /* only when something new was traced */
+  if(hist[0].count == reported)
+    return;
+  reported = hist[0].count;
+
+  latency_report();
+}
+
+#else
+
+void latency_init(void)
+{
+}
+
+void latency_mark(latency_stage_t stage)
+{
+}
+
+void latency_report(void)
+{
+}
+
+#endif /* LATENCY_TRACE */
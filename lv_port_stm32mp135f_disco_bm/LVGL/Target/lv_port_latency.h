@@ -0,0 +1,90 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_latency.h
+  * Description        : This file provides a touch-to-photon latency tracer
+  *                      for the LVGL port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_LATENCY_H
+#define LV_PORT_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/* 1: trace touch-to-photon latency and print it on COM1 */
+#ifndef LATENCY_TRACE
+#define LATENCY_TRACE               0
+#endif
+
+/* 1: FRAME_RATE_Pin is high from the touch interrupt until the frame is
+ * scanned out, instead of around flush_cb (needs the pins in main.h) */
+#ifndef LATENCY_TRACE_GPIO
+#define LATENCY_TRACE_GPIO          0
+#endif
+
+/* 1 ms per bin, the last bin collects everything slower */
+#define LATENCY_BINS                32
+#define LATENCY_BIN_US              1000
+
+/* a touch that did not reach the screen within this is dropped */
+#define LATENCY_TIMEOUT_MS          200
+
+#define LATENCY_REPORT_MS           10000
+
+#if LATENCY_TRACE
+#define LATENCY_MARK(stage)         latency_mark(stage)
+#else
+#define LATENCY_MARK(stage)         do {} while (0)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+  LATENCY_TOUCH,        /* TS_INT interrupt */
+  LATENCY_READ,         /* LVGL input read consumed the sample */
+  LATENCY_RENDER,       /* frame rendered, flush_cb entered */
+  LATENCY_FLUSH,        /* frame buffer address handed to the LTDC */
+  LATENCY_VISIBLE,      /* LTDC left the active area with the new frame */
+  LATENCY_STAGES
+} latency_stage_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void latency_init(void);
+void latency_mark(latency_stage_t stage);
+void latency_report(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_LATENCY_H*/
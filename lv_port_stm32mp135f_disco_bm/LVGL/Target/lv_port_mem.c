@@ -0,0 +1,456 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_mem.c
+  * Description        : This file provides a TLSF allocator in DDR for LVGL
+  *                      with allocation statistics
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "lv_port_mem.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* Two level segregated fit: the first level splits sizes by power of two,
+ * the second level each power of two in SL_COUNT linear steps. Sizes below
+ * SMALL_SIZE all share the first list, in ALIGN_SIZE steps */
+#define ALIGN_SIZE                        8
+#define SL_LOG2                           4
+#define SL_COUNT                          (1 << SL_LOG2)
+#define FL_SHIFT                          (SL_LOG2 + 3)
+#define SMALL_SIZE                        (1 << FL_SHIFT)
+#define FL_MAX_LOG2                       28
+#define FL_COUNT                          (FL_MAX_LOG2 - FL_SHIFT + 1)
+#define MAX_SIZE                          ((1UL << FL_MAX_LOG2) - 1)
+
+/* 8 bytes: payloads stay 8 byte aligned */
+#define HDR_SIZE                          (sizeof(block_t) - 2 * sizeof(block_t *))
+#define MIN_SIZE                          (2 * sizeof(block_t *))
+
+/* size flags, the size is a multiple of ALIGN_SIZE */
+#define BLOCK_FREE                        0x1U
+#define BLOCK_PREV_FREE                   0x2U
+#define BLOCK_FLAGS                       (BLOCK_FREE | BLOCK_PREV_FREE)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct block
+{
+  struct block * prev_phys;         /* the block before in memory */
+  uint32_t size;                    /* payload bytes and flags */
+  /* free blocks only, overlaid on the payload */
+  struct block * next_free;
+  struct block * prev_free;
+} block_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void pool_init(void);
+static void mapping(uint32_t size, uint32_t *fl, uint32_t *sl);
+static block_t * find_free(uint32_t size);
+static void insert_free(block_t *b);
+static void remove_free(block_t *b);
+static block_t * split(block_t *b, uint32_t size);
+static block_t * merge_next(block_t *b);
+static uint32_t size_class(uint32_t size);
+static void account(block_t *b, bool alloc);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* .lvgl_heap in the linker script */
+extern uint8_t __LVGL_HEAP_START__[];
+extern uint8_t __LVGL_HEAP_END__[];
+
+static bool ready;
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[FL_COUNT];
+static block_t * free_lists[FL_COUNT][SL_COUNT];
+
+static uint32_t pool_size;
+static uint32_t used;
+static uint32_t peak;
+static uint32_t allocs[MEM_CLASSES];
+static uint32_t live[MEM_CLASSES];
+
+/**********************
+ *      MACROS
+ **********************/
+#define BLOCK_SIZE(b)                     ((b)->size & ~BLOCK_FLAGS)
+#define BLOCK_NEXT(b)                     ((block_t *)((uint8_t *)(b) + HDR_SIZE + BLOCK_SIZE(b)))
+#define BLOCK_PTR(b)                      ((void *)((uint8_t *)(b) + HDR_SIZE))
+#define PTR_BLOCK(p)                      ((block_t *)((uint8_t *)(p) - HDR_SIZE))
+#define FLS(x)                            (31 - __builtin_clz(x))
+#define FFS(x)                            ((uint32_t)__builtin_ctz(x))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * LV_MEM_CUSTOM_ALLOC, LVGL context only. Bounded time: no list is
+ * searched, the bitmaps point to a free block that fits
+ */
+void * mem_alloc(size_t size)
+{
+  block_t * b;
+
+  if(!ready)
+    pool_init();
+
+  if(size == 0 || size > MAX_SIZE)
+    return NULL;
+
+  size = (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+  if(size < MIN_SIZE)
+    size = MIN_SIZE;
+
+  b = find_free(size);
+  if(b == NULL)
+    return NULL;
+
+  remove_free(b);
+  split(b, size);
+
+  b->size &= ~BLOCK_FREE;
+  BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+
+  account(b, true);
+  return BLOCK_PTR(b);
+}
+
+/**
+ * LV_MEM_CUSTOM_FREE: the block is merged with its free neighbours right
+ * away, in bounded time
+ */
+void mem_free(void * p)
+{
+  block_t * b;
+
+  if(p == NULL)
+    return;
+
+  b = PTR_BLOCK(p);
+  account(b, false);
+
+  b->size |= BLOCK_FREE;
+
+  if(b->size & BLOCK_PREV_FREE)
+  {
+    block_t * prev = b->prev_phys;
+
+    remove_free(prev);
+    prev->size += HDR_SIZE + BLOCK_SIZE(b);
+    b = prev;
+  }
+  b = merge_next(b);
+
+  BLOCK_NEXT(b)->prev_phys = b;
+  BLOCK_NEXT(b)->size |= BLOCK_PREV_FREE;
+  insert_free(b);
+}
+
+/**
+ * LV_MEM_CUSTOM_REALLOC: grows into the next block when it is free
+ */
+void * mem_realloc(void * p, size_t size)
+{
+  block_t * b;
+  block_t * next;
+  uint32_t cur;
+  void * np;
+
+  if(p == NULL)
+    return mem_alloc(size);
+
+  if(size == 0)
+  {
+    mem_free(p);
+    return NULL;
+  }
+
+  if(size > MAX_SIZE)
+    return NULL;
+
+  b = PTR_BLOCK(p);
+  cur = BLOCK_SIZE(b);
+  size = (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+  if(size < MIN_SIZE)
+    size = MIN_SIZE;
+
+  if(size <= cur)
+    return p;
+
+  next = BLOCK_NEXT(b);
+  if((next->size & BLOCK_FREE) && cur + HDR_SIZE + BLOCK_SIZE(next) >= size)
+  {
+    account(b, false);
+    remove_free(next);
+    b->size += HDR_SIZE + BLOCK_SIZE(next);
+    BLOCK_NEXT(b)->prev_phys = b;
+    BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+    split(b, size);
+    account(b, true);
+    return p;
+  }
+
+  np = mem_alloc(size);
+  if(np == NULL)
+    return NULL;
+
+  memcpy(np, p, cur);
+  mem_free(p);
+  return np;
+}
+
+/**
+ * Snapshot of the pool. Walks the free lists, so it takes longer than an
+ * allocation; not for time-critical paths
+ */
+void mem_get_stats(mem_stats_t * stats)
+{
+  uint32_t fl, sl;
+  block_t * b;
+
+  if(!ready)
+    pool_init();
+
+  memset(stats, 0, sizeof(*stats));
+  stats->total = pool_size;
+  stats->used = used;
+  stats->peak = peak;
+
+  for(fl = 0; fl < FL_COUNT; fl++)
+  {
+    for(sl = 0; sl < SL_COUNT; sl++)
+    {
+      for(b = free_lists[fl][sl]; b != NULL; b = b->next_free)
+      {
+        stats->free += BLOCK_SIZE(b);
+        stats->free_blocks++;
+        if(BLOCK_SIZE(b) > stats->free_biggest)
+          stats->free_biggest = BLOCK_SIZE(b);
+      }
+    }
+  }
+
+  if(stats->free)
+    stats->frag_pct = 100 - (uint8_t)((uint64_t)stats->free_biggest * 100 / stats->free);
+
+  memcpy(stats->allocs, allocs, sizeof(allocs));
+  memcpy(stats->live, live, sizeof(live));
+}
+
+/**
+ * Print the statistics on COM1, one line per size class in use
+ */
+void mem_report(void)
+{
+  mem_stats_t stats;
+  uint32_t i;
+
+  mem_get_stats(&stats);
+
+  printf("mem total=%lu used=%lu peak=%lu free=%lu biggest=%lu blocks=%lu frag=%u%%\r\n",
+         stats.total, stats.used, stats.peak, stats.free, stats.free_biggest,
+         stats.free_blocks, stats.frag_pct);
+
+  for(i = 0; i < MEM_CLASSES; i++)
+  {
+    if(stats.allocs[i] == 0)
+      continue;
+    printf("mem %lu+ B allocs=%lu live=%lu\r\n", 8UL << i, stats.allocs[i], stats.live[i]);
+  }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* one free block over the region, then a zero-sized used block that stops
+ * merging at the end */
+static void pool_init(void)
+{
+  uintptr_t start = ((uintptr_t)__LVGL_HEAP_START__ + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+  uintptr_t end = (uintptr_t)__LVGL_HEAP_END__ & ~(ALIGN_SIZE - 1);
+  uint32_t size = end - start - 2 * HDR_SIZE;
+  block_t * b = (block_t *)start;
+  block_t * last;
+
+  if(size > MAX_SIZE)
+    size = MAX_SIZE & ~(ALIGN_SIZE - 1);
+
+  b->prev_phys = NULL;
+  b->size = size | BLOCK_FREE;
+
+  last = BLOCK_NEXT(b);
+  last->prev_phys = b;
+  last->size = BLOCK_PREV_FREE;
+
+  pool_size = size + 2 * HDR_SIZE;
+  insert_free(b);
+  ready = true;
+}
+
+static void mapping(uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+  uint32_t f;
+
+  if(size < SMALL_SIZE)
+  {
+    *fl = 0;
+    *sl = size / (SMALL_SIZE / SL_COUNT);
+  }
+  else
+  {
+    f = FLS(size);
+    *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+    *fl = f - FL_SHIFT + 1;
+  }
+}
+
+/* round the size up to the next list, so any block found there fits */
+static block_t * find_free(uint32_t size)
+{
+  uint32_t fl, sl, map;
+
+  if(size >= SMALL_SIZE)
+    size += (1UL << (FLS(size) - SL_LOG2)) - 1;
+  mapping(size, &fl, &sl);
+
+  if(fl >= FL_COUNT)
+    return NULL;
+
+  map = sl_bitmap[fl] & (~0UL << sl);
+  if(map == 0)
+  {
+    map = (fl + 1 < FL_COUNT) ? fl_bitmap & (~0UL << (fl + 1)) : 0;
+    if(map == 0)
+      return NULL;
+    fl = FFS(map);
+    map = sl_bitmap[fl];
+  }
+  sl = FFS(map);
+
+  return free_lists[fl][sl];
+}
+
+static void insert_free(block_t *b)
+{
+  uint32_t fl, sl;
+
+  mapping(BLOCK_SIZE(b), &fl, &sl);
+
+  b->prev_free = NULL;
+  b->next_free = free_lists[fl][sl];
+  if(b->next_free)
+    b->next_free->prev_free = b;
+  free_lists[fl][sl] = b;
+
+  fl_bitmap |= 1UL << fl;
+  sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void remove_free(block_t *b)
+{
+  uint32_t fl, sl;
+
+  mapping(BLOCK_SIZE(b), &fl, &sl);
+
+  if(b->prev_free)
+    b->prev_free->next_free = b->next_free;
+  else
+    free_lists[fl][sl] = b->next_free;
+  if(b->next_free)
+    b->next_free->prev_free = b->prev_free;
+
+  if(free_lists[fl][sl] == NULL)
+  {
+    sl_bitmap[fl] &= ~(1UL << sl);
+    if(sl_bitmap[fl] == 0)
+      fl_bitmap &= ~(1UL << fl);
+  }
+}
+
+/* give the tail of a block not on a free list back to the pool, if it is
+ * large enough for a block of its own */
+static block_t * split(block_t *b, uint32_t size)
+{
+  block_t * rest;
+  uint32_t rest_size;
+
+  if(BLOCK_SIZE(b) < size + HDR_SIZE + MIN_SIZE)
+    return NULL;
+
+  rest_size = BLOCK_SIZE(b) - size - HDR_SIZE;
+  b->size = size | (b->size & BLOCK_FLAGS);
+
+  rest = BLOCK_NEXT(b);
+  rest->prev_phys = b;
+  rest->size = rest_size | BLOCK_FREE | ((b->size & BLOCK_FREE) ? BLOCK_PREV_FREE : 0);
+  rest = merge_next(rest);
+
+  BLOCK_NEXT(rest)->prev_phys = rest;
+  BLOCK_NEXT(rest)->size |= BLOCK_PREV_FREE;
+  insert_free(rest);
+  return rest;
+}
+
+static block_t * merge_next(block_t *b)
+{
+  block_t * next = BLOCK_NEXT(b);
+
+  if(next->size & BLOCK_FREE)
+  {
+    remove_free(next);
+    b->size += HDR_SIZE + BLOCK_SIZE(next);
+  }
+  return b;
+}
+
+static uint32_t size_class(uint32_t size)
+{
+  uint32_t c = FLS(size) - 3;
+
+  return (c < MEM_CLASSES) ? c : MEM_CLASSES - 1;
+}
+
+static void account(block_t *b, bool alloc)
+{
+  uint32_t size = BLOCK_SIZE(b);
+  uint32_t c = size_class(size);
+
+  if(alloc)
+  {
+    allocs[c]++;
+    live[c]++;
+    used += HDR_SIZE + size;
+    if(used > peak)
+      peak = used;
+  }
+  else
+  {
+    live[c]--;
+    used -= HDR_SIZE + size;
+  }
+}
@@ -0,0 +1,72 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_mem.h
+  * Description        : This file provides a TLSF allocator in DDR for LVGL
+  *                      with allocation statistics
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_MEM_H
+#define LV_PORT_MEM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+/* included by lv_conf.h through LV_MEM_CUSTOM_INCLUDE, keep it free of
+ * LVGL headers */
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* size class n holds blocks of 2^(n+3) to 2^(n+4)-1 bytes, the last one
+ * everything larger */
+#define MEM_CLASSES                       24
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+  uint32_t total;                   /* pool size */
+  uint32_t used;                    /* allocated blocks, headers included */
+  uint32_t peak;                    /* highest used since start */
+  uint32_t free;                    /* free blocks, headers excluded */
+  uint32_t free_biggest;            /* largest possible allocation */
+  uint32_t free_blocks;
+  uint8_t frag_pct;                 /* 100 - free_biggest / free */
+  uint32_t allocs[MEM_CLASSES];     /* allocations since start */
+  uint32_t live[MEM_CLASSES];       /* blocks allocated now */
+} mem_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void * mem_alloc(size_t size);
+void mem_free(void * p);
+void * mem_realloc(void * p, size_t size);
+void mem_get_stats(mem_stats_t * stats);
+void mem_report(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_MEM_H*/
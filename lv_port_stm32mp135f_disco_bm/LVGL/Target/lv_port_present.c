@@ -0,0 +1,140 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_present.c
+  * Description        : This file provides the predicted presentation time
+  *                      used as the LVGL animation time base
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "main.h"
+#include "lv_port_present.h"
+#include "lv_port_disp.h"
+#include "lv_port_tick.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/* period average weight 1/8 */
+#define PERIOD_AVG                        8
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* written by the LTDC interrupt */
+static volatile uint32_t frame_us;
+static volatile uint32_t period_us;
+
+static uint32_t sample_us;
+static uint32_t depth = 1;
+static uint32_t last_ms;
+static bool sampled;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Animations run from present_anim_refr(), their own timer is only the
+ * fallback when no frame start comes
+ */
+void present_init(void)
+{
+  lv_timer_set_period(lv_anim_get_timer(), DISP_VSYNC_FALLBACK_MS);
+}
+
+/**
+ * LTDC frame start, from the interrupt. Measures the refresh period,
+ * counting the frames missed in between
+ */
+void present_frame_start(void)
+{
+  uint32_t now = tick_get_us();
+  uint32_t elapsed = now - frame_us;
+  uint32_t period = period_us;
+  uint32_t frames;
+
+  frame_us = now;
+
+  if(elapsed >= PRESENT_MAX_PERIOD_US)
+    return;
+
+  if(period == 0)
+  {
+    period_us = elapsed;
+    return;
+  }
+
+  frames = (elapsed + period / 2) / period;
+  if(frames)
+    period_us = period + ((int32_t)(elapsed / frames) - (int32_t)period) / PERIOD_AVG;
+}
+
+/**
+ * The frame sampled by the last present_anim_refr() went to the LTDC: the
+ * number of frame starts it took is the depth of the next prediction
+ */
+void present_flushed(void)
+{
+  uint32_t period = period_us;
+
+  if(!sampled || period == 0)
+    return;
+  sampled = false;
+
+  depth = LV_MIN((tick_get_us() - sample_us) / period + 1, PRESENT_MAX_DEPTH);
+}
+
+/**
+ * Run the animations at the time the frame about to be rendered will be
+ * shown, instead of at the time it is rendered. Call it from the LVGL loop
+ * right after a frame start, before refreshing the display
+ */
+void present_anim_refr(void)
+{
+  uint32_t now_us, now_ms, present_us, ms;
+
+  __disable_irq();
+  sample_us = frame_us;
+  present_us = sample_us + depth * period_us;
+  __enable_irq();
+
+  now_us = tick_get_us();
+  now_ms = tick_get_ms();
+  ms = now_ms;
+  if((int32_t)(present_us - now_us) > 0)
+    ms += (present_us - now_us) / 1000;
+
+  /* the animation time must never go back */
+  if((int32_t)(ms - last_ms) < 0)
+    ms = last_ms;
+  last_ms = ms;
+
+  tick_freeze(ms);
+  lv_anim_refr_now();
+  tick_thaw();
+
+  /* keep the animation timer from running again with the real time, which
+   * is behind the presentation time */
+  lv_timer_reset(lv_anim_get_timer());
+  sampled = true;
+}
+
+uint32_t present_get_period_us(void)
+{
+  return period_us;
+}
@@ -0,0 +1,55 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_present.h
+  * Description        : This file provides the predicted presentation time
+  *                      used as the LVGL animation time base
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_PRESENT_H
+#define LV_PORT_PRESENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* frame start intervals above this are gaps, not the refresh period */
+#define PRESENT_MAX_PERIOD_US             50000
+
+/* frames between the animation sample and the frame on screen */
+#define PRESENT_MAX_DEPTH                 3
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void present_init(void);
+void present_frame_start(void);
+void present_flushed(void);
+void present_anim_refr(void);
+uint32_t present_get_period_us(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_PRESENT_H*/
@@ -0,0 +1,251 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_record.c
+  * Description        : This file provides input recording and replay for the
+  *                      LVGL input device port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "lv_port_record.h"
+
+#if RECORD
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static record_event_t record_buf[RECORD_MAX_EVENTS];
+static uint32_t record_count;
+static uint32_t record_start_tick;
+static bool recording;
+static bool last_released;
+
+static const record_event_t * replay_events;
+static uint32_t replay_count;
+static uint32_t replay_pos;
+static uint32_t replay_start_tick;
+static replay_done_cb_t replay_done;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Start logging what the read callback reports, from an empty buffer
+ */
+void record_start(void)
+{
+  record_count = 0;
+  record_start_tick = lv_tick_get();
+  last_released = true;
+  recording = true;
+}
+
+/**
+ * Stop logging
+ * @return number of recorded events
+ */
+uint32_t record_stop(void)
+{
+  recording = false;
+  return record_count;
+}
+
+const record_event_t * record_get(uint32_t *count)
+{
+  *count = record_count;
+  return record_buf;
+}
+
+void record_dump(void)
+{
+  uint32_t i;
+
+  printf("static const record_event_t recording[] = {\r\n");
+  for(i = 0; i < record_count; i++)
+    printf("  { %lu, %d, %d },\r\n", record_buf[i].time, record_buf[i].x, record_buf[i].y);
+  printf("};\r\n");
+}
+
+void replay_start(const record_event_t *events, uint32_t count, replay_done_cb_t done_cb)
+{
+  recording = false;
+  replay_events = events;
+  replay_count = count;
+  replay_pos = 0;
+  replay_done = done_cb;
+  replay_start_tick = lv_tick_get();
+}
+
+void replay_stop(void)
+{
+  replay_events = NULL;
+}
+
+bool replay_pending(void)
+{
+  return (replay_events != NULL) &&
+         ((replay_pos == replay_count) ||
+          (lv_tick_elaps(replay_start_tick) >= replay_events[replay_pos].time));
+}
+
+/**
+ * Time until the next replayed event is due
+ * @return ms, LV_NO_TIMER_READY when not replaying
+ */
+uint32_t replay_wait(void)
+{
+  uint32_t elapsed;
+
+  if(replay_events == NULL)
+    return LV_NO_TIMER_READY;
+  if(replay_pos == replay_count)
+    return 0;
+
+  elapsed = lv_tick_elaps(replay_start_tick);
+  return (elapsed >= replay_events[replay_pos].time) ? 0 : replay_events[replay_pos].time - elapsed;
+}
+
+/**
+ * Report the next due event
+ * @return false when not replaying: read the panel instead
+ */
+bool replay_read(lv_indev_data_t *data)
+{
+  static lv_point_t last;
+  const record_event_t * ev;
+
+  if(replay_events == NULL)
+    return false;
+
+  /* end of the recording: release and hand the panel back */
+  if(replay_pos == replay_count)
+  {
+    replay_done_cb_t done = replay_done;
+
+    data->point = last;
+    data->state = LV_INDEV_STATE_RELEASED;
+    replay_events = NULL;
+    if(done)
+      done();
+    return true;
+  }
+
+  /* nothing due yet: hold the last state */
+  if(lv_tick_elaps(replay_start_tick) < replay_events[replay_pos].time)
+  {
+    data->point = last;
+    data->state = (replay_pos && (replay_events[replay_pos - 1].x != RECORD_RELEASED)) ?
+                  LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    return true;
+  }
+
+  ev = &replay_events[replay_pos++];
+  if(ev->x == RECORD_RELEASED)
+  {
+    data->state = LV_INDEV_STATE_RELEASED;
+  }
+  else
+  {
+    last.x = ev->x;
+    last.y = ev->y;
+    data->state = LV_INDEV_STATE_PRESSED;
+  }
+  data->point = last;
+
+  /* catch up on events that fell due within the same main loop cycle */
+  data->continue_reading = (replay_pos < replay_count) &&
+                           (lv_tick_elaps(replay_start_tick) >= replay_events[replay_pos].time);
+  return true;
+}
+
+/**
+ * Log the state handed to LVGL, repeated releases only once
+ */
+void record_read(const lv_indev_data_t *data)
+{
+  bool released = (data->state == LV_INDEV_STATE_RELEASED);
+  record_event_t * ev;
+
+  if(!recording || (released && last_released))
+    return;
+  last_released = released;
+
+  if(record_count == RECORD_MAX_EVENTS)
+  {
+    recording = false;
+    return;
+  }
+
+  ev = &record_buf[record_count++];
+  ev->time = lv_tick_elaps(record_start_tick);
+  ev->x = released ? RECORD_RELEASED : data->point.x;
+  ev->y = released ? RECORD_RELEASED : data->point.y;
+}
+
+#else
+
+void record_start(void)
+{
+}
+
+uint32_t record_stop(void)
+{
+  return 0;
+}
+
+const record_event_t * record_get(uint32_t *count)
+{
+  *count = 0;
+  return NULL;
+}
+
+void record_dump(void)
+{
+}
+
+void replay_start(const record_event_t *events, uint32_t count, replay_done_cb_t done_cb)
+{
+  if(done_cb)
+    done_cb();
+}
+
+void replay_stop(void)
+{
+}
+
+bool replay_pending(void)
+{
+  return false;
+}
+
+uint32_t replay_wait(void)
+{
+  return LV_NO_TIMER_READY;
+}
+
+bool replay_read(lv_indev_data_t *data)
+{
+  return false;
+}
+
+void record_read(const lv_indev_data_t *data)
+{
+}
+
+#endif /* RECORD */
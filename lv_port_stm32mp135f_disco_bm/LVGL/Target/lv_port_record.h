@@ -0,0 +1,92 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_record.h
+  * Description        : This file provides input recording and replay for the
+  *                      LVGL input device port
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_RECORD_H
+#define LV_PORT_RECORD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/* 1: record and replay pointer input, 0: the calls below are no-ops and
+ * the recording buffer is not linked */
+#ifndef RECORD
+#define RECORD                      0
+#endif
+
+/* recording buffer in RAM, 8 bytes per event */
+#define RECORD_MAX_EVENTS           4096
+
+/* x < 0 marks a release at the previous point */
+#define RECORD_RELEASED             (-1)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* what the touchscreen read callback handed to LVGL */
+typedef struct
+{
+  uint32_t time;      /* ms since the start of the recording */
+  int16_t x;
+  int16_t y;
+} record_event_t;
+
+typedef void (*replay_done_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void record_start(void);
+uint32_t record_stop(void);
+const record_event_t * record_get(uint32_t *count);
+
+/* print the recording as a C array on COM1, to be compiled into a
+ * firmware or simulator build and passed to replay_start(); on a
+ * simulator call replay_read() from its pointer read callback */
+void record_dump(void);
+
+/* feed events through the touchscreen input device with their original
+ * timing, the panel is ignored until done */
+void replay_start(const record_event_t *events, uint32_t count, replay_done_cb_t done_cb);
+void replay_stop(void);
+
+/* hooks for the read callback: an event is due, take it / log the result */
+bool replay_pending(void);
+uint32_t replay_wait(void);
+bool replay_read(lv_indev_data_t *data);
+void record_read(const lv_indev_data_t *data);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_RECORD_H*/
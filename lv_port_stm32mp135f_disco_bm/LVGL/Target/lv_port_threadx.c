@@ -0,0 +1,165 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_threadx.c
+  * Description        : This file provides the ThreadX variant of the LVGL
+  *                      main loop (USE_THREADX builds)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#if defined(USE_THREADX)
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "main.h"
+#include "tx_api.h"
+#include "lv_port_threadx.h"
+#include "lv_port_indev.h"
+#include "lv_port_defer.h"
+#include "lv_port_disp.h"
+#if defined(LV_LVGL_H_INCLUDE_SIMPLE)
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MS_TO_TICKS(ms)     (((ms) * TX_TIMER_TICKS_PER_SECOND + 999UL) / 1000UL)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void render_thread_entry(ULONG arg);
+static void app_thread_entry(ULONG arg);
+static ULONG wait_ticks(uint32_t ms);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static TX_THREAD render_thread;
+static TX_THREAD app_thread;
+static TX_MUTEX lvgl_mutex;
+static TX_EVENT_FLAGS_GROUP events;
+
+static ULONG render_stack[THREADX_RENDER_STACK_SIZE / sizeof(ULONG)];
+static ULONG app_stack[THREADX_APP_STACK_SIZE / sizeof(ULONG)];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * LVGL, the display and the input device are initialized by main()
+ */
+void threadx_start(void)
+{
+  tx_kernel_enter();
+}
+
+/**
+ * Called by tx_kernel_enter() before the scheduler starts
+ */
+void tx_application_define(void *first_unused_memory)
+{
+  tx_mutex_create(&lvgl_mutex, "lvgl", TX_INHERIT);
+  tx_event_flags_create(&events, "lvgl events");
+
+  tx_thread_create(&render_thread, "lvgl render", render_thread_entry, 0,
+                   render_stack, sizeof(render_stack),
+                   THREADX_RENDER_PRIO, THREADX_RENDER_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+  tx_thread_create(&app_thread, "app data", app_thread_entry, 0,
+                   app_stack, sizeof(app_stack),
+                   THREADX_APP_PRIO, THREADX_APP_PRIO, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+
+/**
+ * Interrupt or thread context
+ */
+void threadx_signal(uint32_t flags)
+{
+  tx_event_flags_set(&events, flags, TX_OR);
+}
+
+/**
+ * Block the calling thread until one of the events is set
+ */
+void threadx_wait(uint32_t flags)
+{
+  ULONG actual;
+
+  tx_event_flags_get(&events, flags, TX_OR_CLEAR, &actual, TX_WAIT_FOREVER);
+}
+
+void lv_port_lock(void)
+{
+  tx_mutex_get(&lvgl_mutex, TX_WAIT_FOREVER);
+}
+
+/**
+ * The render thread picks up whatever the caller changed
+ */
+void lv_port_unlock(void)
+{
+  tx_mutex_put(&lvgl_mutex);
+  threadx_signal(THREADX_EVENT_RENDER);
+}
+
+__weak void app_data_thread(void)
+{
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* the I2C reads are interrupt driven and queue the reports; LVGL is not
+ * reentrant, so they are handed to it here, between frames: a report
+ * that arrives while a frame renders or waits for the blanking is fed
+ * right after it */
+static void render_thread_entry(ULONG arg)
+{
+  ULONG actual;
+  uint32_t wait;
+
+  for(;;)
+  {
+    tx_mutex_get(&lvgl_mutex, TX_WAIT_FOREVER);
+    defer_drain();
+    wait = lv_port_indev_process();
+    disp_vsync_process();
+    wait = LV_MIN(wait, lv_timer_handler());
+    defer_drain();
+    tx_mutex_put(&lvgl_mutex);
+
+    tx_event_flags_get(&events, THREADX_EVENT_INPUT | THREADX_EVENT_RENDER, TX_OR_CLEAR,
+                       &actual, wait_ticks(wait));
+  }
+}
+
+static void app_thread_entry(ULONG arg)
+{
+  app_data_thread();
+}
+
+static ULONG wait_ticks(uint32_t ms)
+{
+  if(ms == LV_NO_TIMER_READY)
+    return TX_WAIT_FOREVER;
+  return (ms == 0) ? TX_NO_WAIT : MS_TO_TICKS(ms);
+}
+
+#endif /* USE_THREADX */
@@ -0,0 +1,70 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_threadx.h
+  * Description        : This file provides the ThreadX variant of the LVGL
+  *                      main loop (USE_THREADX builds)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_THREADX_H
+#define LV_PORT_THREADX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/* higher number = lower priority */
+#define THREADX_RENDER_PRIO         10
+#define THREADX_APP_PRIO            12
+
+#define THREADX_RENDER_STACK_SIZE   (16 * 1024)
+#define THREADX_APP_STACK_SIZE      (8 * 1024)
+
+/* event flags, set from interrupts or threads */
+#define THREADX_EVENT_INPUT         0x1U    /* touch report queued */
+#define THREADX_EVENT_RENDER        0x2U    /* LVGL has new work */
+#define THREADX_EVENT_VBLANK        0x4U    /* LTDC left the active area */
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+/* enter the kernel instead of the main loop, does not return */
+void threadx_start(void);
+
+void threadx_signal(uint32_t events);
+void threadx_wait(uint32_t events);
+
+/* LVGL v8 has no OS layer: take this lock around every LVGL call made
+ * outside the render thread */
+void lv_port_lock(void);
+void lv_port_unlock(void);
+
+/* application data thread body, defined by the application; may block
+ * on SD card, flash or sensors without holding up rendering */
+void app_data_thread(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_THREADX_H*/
@@ -0,0 +1,102 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_tick.c
+  * Description        : This file provides the LVGL tick and a microsecond
+  *                      time base from the Cortex-A7 generic timer
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "main.h"
+#include "lv_port_tick.h"
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static volatile uint8_t frozen;
+static uint32_t frozen_ms;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * LVGL tick (LV_TICK_CUSTOM_SYS_TIME_EXPR): the system time, or the time
+ * set by tick_freeze()
+ */
+uint32_t tick_get_lvgl(void)
+{
+  return frozen ? frozen_ms : tick_get_ms();
+}
+
+/**
+ * Make LVGL see the given time until tick_thaw(), e.g. to run the
+ * animations at the time their frame is shown. LVGL context only
+ */
+void tick_freeze(uint32_t ms)
+{
+  frozen_ms = ms;
+  frozen = 1;
+}
+
+void tick_thaw(void)
+{
+  frozen = 0;
+}
+
+/**
+ * System time in ms. Unlike the weak HAL_GetTick(), the 64 bit counter is
+ * divided before truncation, so the result wraps after 2^32 ms and not
+ * every 2^32 timer ticks (~3 min at 24 MHz)
+ */
+uint32_t tick_get_ms(void)
+{
+  return (uint32_t)(tick_get_us64() / 1000UL);
+}
+
+/**
+ * Free-running microseconds, for profiling; differences stay valid
+ * across the 32 bit wrap (~71 min)
+ */
+uint32_t tick_get_us(void)
+{
+  return (uint32_t)tick_get_us64();
+}
+
+uint64_t tick_get_us64(void)
+{
+  return PL1_GetCurrentPhysicalValue() / (tick_get_freq() / 1000000UL);
+}
+
+/**
+ * Generic timer frequency: it counts at the STGEN clock
+ */
+uint32_t tick_get_freq(void)
+{
+  if((RCC->STGENCKSELR & RCC_STGENCKSELR_STGENSRC) == RCC_STGENCLKSOURCE_HSE)
+    return HSE_VALUE;
+  else
+    return HSI_VALUE;
+}
+
+/**
+ * Same time base for the HAL, the touch timestamps are compared with it
+ */
+uint32_t HAL_GetTick(void)
+{
+  return tick_get_ms();
+}
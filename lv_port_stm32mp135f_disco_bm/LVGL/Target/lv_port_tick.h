@@ -0,0 +1,50 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * File Name          : Target/lv_port_tick.h
+  * Description        : This file provides the LVGL tick and a microsecond
+  *                      time base from the Cortex-A7 generic timer
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2024 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+#ifndef LV_PORT_TICK_H
+#define LV_PORT_TICK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+/* included by lv_conf.h through LV_TICK_CUSTOM_INCLUDE, keep it free of
+ * LVGL headers */
+#include <stdint.h>
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+uint32_t tick_get_lvgl(void);
+void tick_freeze(uint32_t ms);
+void tick_thaw(void);
+uint32_t tick_get_ms(void);
+uint32_t tick_get_freq(void);
+uint32_t tick_get_us(void);
+uint64_t tick_get_us64(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_PORT_TICK_H*/
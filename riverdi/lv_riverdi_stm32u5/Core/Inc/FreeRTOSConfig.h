@@ -162,6 +162,9 @@ header file. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+/* tickless idle with LPTIM2 as wake-up timer, see lvgl_port_sleep.c */
+#define configUSE_TICKLESS_IDLE                  2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    2
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,63 @@
+#ifndef __LVGL_PORT_ARENA_H
+#define __LVGL_PORT_ARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* arenas alive at once, e.g. the screen shown and the one loading */
+#define LVGL_ARENA_MAX            4
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*
+ * Serve the LVGL task's lv_malloc() from one block of size bytes, taken
+ * from the heap, until lvgl_arena_end(): build a screen in between.
+ * Allocations are bumped off the block and lv_free() only counts them;
+ * the block goes back to the heap as a whole once they are all freed.
+ * Allocations fall back to the heap when the block is full. Returns false
+ * when there is no memory for the block, then everything uses the heap
+ */
+bool
+lvgl_arena_begin (size_t size);
+
+/* stop filling the arena, it is released once scr is deleted; returns the
+ * bytes used, to size the arena */
+size_t
+lvgl_arena_end (lv_obj_t * scr);
+
+/* allocations that outlive the screen, e.g. shared styles or caches,
+ * must come from the heap: wrap them in suspend/resume */
+void
+lvgl_arena_suspend (void);
+
+void
+lvgl_arena_resume (void);
+
+/* hooks for lvgl_port_heap.c; NULL / false: not an arena's, use the heap */
+void *
+lvgl_arena_alloc (size_t size);
+
+bool
+lvgl_arena_realloc (void **p, size_t size);
+
+bool
+lvgl_arena_free (void *p);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_ARENA_H */
@@ -0,0 +1,80 @@
+#ifndef __LVGL_PORT_CACHE_H
+#define __LVGL_PORT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* DCACHE1/DCACHE2 only sit in front of the external memory window (FMC,
+ * OCTOSPI, HSPI); internal SRAM is never cached and needs no maintenance */
+#define LVGL_CACHE_REGION_START      0x60000000UL
+#define LVGL_CACHE_REGION_END        0xA0000000UL
+
+#define LVGL_CACHE_LINE_SIZE         16U
+
+/* above this size a whole-cache operation beats walking the range */
+#define LVGL_CACHE_FULL_THRESHOLD    (16U * 1024U)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum
+{
+  LVGL_CACHE_MASTER_DMA2D,
+  LVGL_CACHE_MASTER_LTDC,
+  LVGL_CACHE_MASTER_GPU2D,
+} lvgl_cache_master_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* CPU side (DCACHE1) */
+void
+lvgl_cache_clean (const void * addr, size_t size);
+
+void
+lvgl_cache_invalidate (const void * addr, size_t size);
+
+void
+lvgl_cache_clean_invalidate (const void * addr, size_t size);
+
+/* call before a bus master reads a buffer written by the CPU */
+void
+lvgl_cache_to_master (lvgl_cache_master_t master, const void * addr, size_t size);
+
+/* call after a bus master wrote a buffer the CPU is going to read */
+void
+lvgl_cache_from_master (lvgl_cache_master_t master, const void * addr, size_t size);
+
+#ifdef DEBUG
+/* record CPU writes so that lvgl_cache_check() can catch a missing clean */
+void
+lvgl_cache_mark_dirty (const void * addr, size_t size);
+
+void
+lvgl_cache_check (const void * addr, size_t size);
+#define LVGL_CACHE_MARK_DIRTY(addr, size)  lvgl_cache_mark_dirty((addr), (size))
+#define LVGL_CACHE_CHECK(addr, size)       lvgl_cache_check((addr), (size))
+#else
+#define LVGL_CACHE_MARK_DIRTY(addr, size)  do {} while (0)
+#define LVGL_CACHE_CHECK(addr, size)       do {} while (0)
+#endif
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_CACHE_H */
@@ -18,6 +18,21 @@ extern "C" {
 #define MY_DISP_HOR_RES    800
 #define MY_DISP_VER_RES    480
 
+/* 1: render on the LTDC frame timing instead of a free-running timer,
+ * 0: every LV_DEF_REFR_PERIOD */
+#ifndef LVGL_VSYNC_REFRESH
+#define LVGL_VSYNC_REFRESH         1
+#endif
+
+/* refresh anyway when no line event came, e.g. with the LTDC stopped */
+#define LVGL_VSYNC_FALLBACK_MS     100
+
+/* turn the panel off after this long without input, and the core idles in
+ * Stop 1 until the next touch; 0: never */
+#ifndef LVGL_DISPLAY_OFF_MS
+#define LVGL_DISPLAY_OFF_MS        0
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -25,6 +40,27 @@ extern "C" {
 void
 lvgl_display_init (void);
 
+/* one LTDC line event at the start of the next vertical blanking, thread
+ * or ISR */
+void
+lvgl_display_vblank_request (void);
+
+/* render the frame due at the last vertical blanking and ask for the next
+ * one if something is left to draw; LVGL task, lock held, right before
+ * lv_timer_handler() */
+void
+lvgl_display_vsync_process (void);
+
+/* render at every n-th vertical blanking, 1 for every one */
+void
+lvgl_display_set_frame_divider (uint32_t n);
+
+/* turn the display off after LVGL_DISPLAY_OFF_MS without input and back
+ * on with the next one; LVGL task, lock held, after the touchscreen was
+ * processed. Returns the ms until it needs to run again */
+uint32_t
+lvgl_display_idle_process (void);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
@@ -0,0 +1,75 @@
+#ifndef __LVGL_PORT_DMA2D_H
+#define __LVGL_PORT_DMA2D_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define LVGL_DMA2D_QUEUE_LEN    8
+
+/* thread flag lvgl_dma2d_run() waits on, apart from LVGL_TASK_FLAG_WAKE */
+#define LVGL_DMA2D_FLAG_DONE    0x0100U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*
+ * One DMA2D transfer, described by its register values. Jobs run in
+ * submission order; done() is called from the DMA2D interrupt.
+ */
+typedef struct
+{
+  uint32_t cr;              /* transfer mode, interrupt enables are added */
+  uint32_t fgmar;
+  uint32_t fgor;
+  uint32_t fgpfccr;
+  uint32_t fgcolr;
+  uint32_t fgcmar;          /* CLUT address, 0 when the input has no CLUT */
+  uint32_t bgmar;
+  uint32_t bgor;
+  uint32_t bgpfccr;
+  uint32_t opfccr;
+  uint32_t ocolr;
+  uint32_t omar;
+  uint32_t oor;
+  uint32_t nlr;
+  void (*done) (void * user_data, bool ok);
+  void * user_data;
+} lvgl_dma2d_job_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+void
+lvgl_dma2d_init (void);
+
+/* queue a job (copied), returns false when the queue is full */
+bool
+lvgl_dma2d_submit (const lvgl_dma2d_job_t * job);
+
+/* queue a job and block the calling task until it is done, returns false
+ * on a DMA2D error; from a task, after the scheduler started */
+bool
+lvgl_dma2d_run (const lvgl_dma2d_job_t * job);
+
+bool
+lvgl_dma2d_busy (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_DMA2D_H */
@@ -0,0 +1,61 @@
+#ifndef __LVGL_PORT_GOVERNOR_H
+#define __LVGL_PORT_GOVERNOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* 1: lower the rendering quality while frames take longer than the budget */
+#ifndef LVGL_GOVERNOR
+#define LVGL_GOVERNOR                 0
+#endif
+
+#define LVGL_GOVERNOR_UART            huart1
+
+/* render time budget when the LTDC period is not measured yet */
+#define LVGL_GOVERNOR_BUDGET_US       16000
+
+/* step down after this many frames over the budget in a row */
+#define LVGL_GOVERNOR_OVER_FRAMES     3
+
+/* step up after this many frames under the headroom in a row */
+#define LVGL_GOVERNOR_UNDER_FRAMES    30
+#define LVGL_GOVERNOR_HEADROOM_PCT    50
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum
+{
+  LVGL_GOVERNOR_FULL,       /* everything as styled */
+  LVGL_GOVERNOR_REDUCED,    /* no shadows, nearest neighbour image transforms */
+  LVGL_GOVERNOR_MINIMAL,    /* also no anti-aliasing, half the frame rate */
+} lvgl_governor_level_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* watch the render time of the default display, after lvgl_display_init() */
+void
+lvgl_governor_init (void);
+
+lvgl_governor_level_t
+lvgl_governor_get_level (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_GOVERNOR_H */
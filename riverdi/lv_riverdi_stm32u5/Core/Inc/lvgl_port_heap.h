@@ -0,0 +1,50 @@
+#ifndef __LVGL_PORT_HEAP_H
+#define __LVGL_PORT_HEAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* regions that can be added after lvgl_heap_init() */
+#define LVGL_HEAP_MAX_REGIONS     4
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* one heap for pvPortMalloc() and lv_malloc(), over the regions given by
+ * the linker script; before the scheduler starts */
+void
+lvgl_heap_init (void);
+
+/* hand more memory to the heap, e.g. an SRAM freed at run time; returns
+ * false when the region is too small or the table is full */
+bool
+lvgl_heap_add_region (void *start, size_t size);
+
+void *
+lvgl_heap_alloc (size_t size);
+
+void
+lvgl_heap_free (void *p);
+
+void *
+lvgl_heap_realloc (void *p, size_t size);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_HEAP_H */
@@ -0,0 +1,66 @@
+#ifndef __LVGL_PORT_IMAGE_H
+#define __LVGL_PORT_IMAGE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/*
+ * Palettized images expanded by DMA2D (M2M with PFC + CLUT).
+ *
+ * Plain LVGL I8 images (LV_COLOR_FORMAT_I8: 256 ARGB8888 palette entries
+ * followed by one index per pixel) are handled as DMA2D L8.
+ *
+ * L4, AL44 and AL88 have no LVGL color format; they are stored as
+ * LV_COLOR_FORMAT_RAW_ALPHA with LVGL_IMAGE_FLAG_CLUT set in the header
+ * flags, and the data starts with an lvgl_clut_header_t, followed by the
+ * ARGB8888 palette and the pixels in DMA2D order. Utilities/lv_clut_conv.py
+ * produces both kinds from PNG files.
+ *
+ * Images are expanded to RGB565 when the palette is fully opaque, to
+ * ARGB8888 otherwise; the result is allocated from the LVGL heap.
+ */
+#define LVGL_IMAGE_FLAG_CLUT    LV_IMAGE_FLAGS_USER1
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* values match the DMA2D FGPFCCR.CM encoding */
+typedef enum
+{
+  LVGL_CLUT_L8   = 0x5,
+  LVGL_CLUT_AL44 = 0x6,
+  LVGL_CLUT_AL88 = 0x7,
+  LVGL_CLUT_L4   = 0x8,
+} lvgl_clut_format_t;
+
+typedef struct
+{
+  uint8_t format;       /* lvgl_clut_format_t */
+  uint8_t opaque;       /* 1: no transparent pixel in the image */
+  uint16_t clut_size;   /* palette entries, 1..256 */
+} lvgl_clut_header_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+void
+lvgl_image_init (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_IMAGE_H */
@@ -0,0 +1,75 @@
+#ifndef __LVGL_PORT_LATENCY_H
+#define __LVGL_PORT_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* 1: trace touch-to-photon latency and report it on the UART */
+#ifndef LVGL_LATENCY_TRACE
+#define LVGL_LATENCY_TRACE          0
+#endif
+
+#define LVGL_LATENCY_UART           huart1
+
+/* 1 ms per bin, the last bin collects everything slower */
+#define LVGL_LATENCY_BINS           32
+#define LVGL_LATENCY_BIN_US         1000
+
+/* a touch that did not reach the screen within this is dropped */
+#define LVGL_LATENCY_TIMEOUT_MS     200
+
+#define LVGL_LATENCY_REPORT_MS      10000
+
+#if LVGL_LATENCY_TRACE
+#define LVGL_LATENCY_MARK(stage)    lvgl_latency_mark(stage)
+#else
+#define LVGL_LATENCY_MARK(stage)    do {} while (0)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum
+{
+  LVGL_LATENCY_TOUCH,       /* touch controller interrupt */
+  LVGL_LATENCY_READ,        /* LVGL input read consumed the sample */
+  LVGL_LATENCY_RENDER,      /* frame rendered, last flush started */
+  LVGL_LATENCY_FLUSH,       /* last flush reached the frame buffer */
+  LVGL_LATENCY_VISIBLE,     /* LTDC finished scanning the frame out */
+  LVGL_LATENCY_STAGES
+} lvgl_latency_stage_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* no-op unless LVGL_LATENCY_TRACE */
+void
+lvgl_latency_init (void);
+
+/* thread or interrupt context; stages are only taken in order, one
+ * touch at a time */
+void
+lvgl_latency_mark (lvgl_latency_stage_t stage);
+
+/* print the histograms now, also done every LVGL_LATENCY_REPORT_MS */
+void
+lvgl_latency_report (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_LATENCY_H */
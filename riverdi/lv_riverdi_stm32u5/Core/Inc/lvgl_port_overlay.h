@@ -0,0 +1,64 @@
+#ifndef __LVGL_PORT_OVERLAY_H
+#define __LVGL_PORT_OVERLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* largest overlay window; the layer buffer is 2 bytes per pixel */
+#define LVGL_OVERLAY_MAX_W        800
+#define LVGL_OVERLAY_MAX_H        96
+
+/* lines rendered per pass in ARGB8888 */
+#define LVGL_OVERLAY_DRAW_LINES   24
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum
+{
+  LVGL_OVERLAY_ARGB4444,    /* full colour, 4-bit alpha */
+  LVGL_OVERLAY_AL88,        /* luminance through a tint CLUT, 8-bit alpha */
+} lvgl_overlay_format_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/*
+ * Create an overlay on LTDC layer 1, blended by the LTDC over the main
+ * display. The overlay is an lv_display of its own with a transparent
+ * screen: build the toast/status bar/dialog on lv_display_get_screen_active()
+ * of the returned display. Input stays with the main display.
+ * The layer starts hidden.
+ */
+lv_display_t *
+lvgl_overlay_create (int32_t x, int32_t y, int32_t w, int32_t h,
+                     lvgl_overlay_format_t format);
+
+void
+lvgl_overlay_show (bool show);
+
+void
+lvgl_overlay_move (int32_t x, int32_t y);
+
+/* AL88 only: colour shown at full luminance (default white) */
+void
+lvgl_overlay_set_tint (lv_color_t color);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_OVERLAY_H */
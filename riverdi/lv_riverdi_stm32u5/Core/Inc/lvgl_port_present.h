@@ -0,0 +1,54 @@
+#ifndef __LVGL_PORT_PRESENT_H
+#define __LVGL_PORT_PRESENT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* line event intervals above this are gaps, not the refresh period */
+#define LVGL_PRESENT_MAX_PERIOD_US    50000
+
+/* frames between the animation sample and the frame on screen */
+#define LVGL_PRESENT_MAX_DEPTH        3
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* animations run from lvgl_present_anim_refresh(), their own timer only
+ * as the fallback */
+void
+lvgl_present_init (void);
+
+/* vertical blanking started, from the LTDC line event */
+void
+lvgl_present_vblank (void);
+
+/* the last flush of the sampled frame reached the frame buffer, ISR */
+void
+lvgl_present_flushed (void);
+
+/* run the animations at the time the next frame will be shown, right
+ * before rendering it; LVGL task, lock held */
+void
+lvgl_present_anim_refresh (void);
+
+/* measured LTDC refresh period, 0 until known */
+uint32_t
+lvgl_present_get_period_us (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_PRESENT_H */
@@ -0,0 +1,92 @@
+#ifndef __LVGL_PORT_RECORD_H
+#define __LVGL_PORT_RECORD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* 1: record and replay pointer input, 0: the calls below are no-ops and
+ * the recording buffer is not linked */
+#ifndef LVGL_RECORD
+#define LVGL_RECORD               0
+#endif
+
+/* recording buffer in RAM, 8 bytes per event */
+#define LVGL_RECORD_MAX_EVENTS    4096
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* what the touchscreen read callback handed to LVGL */
+typedef struct
+{
+  uint32_t time;      /* ms since the start of the recording */
+  int16_t x;
+  int16_t y;
+} lvgl_record_event_t;
+
+/* x < 0 marks a release at the previous point */
+#define LVGL_RECORD_RELEASED      (-1)
+
+typedef void (*lvgl_replay_done_cb_t) (void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+void
+lvgl_record_start (void);
+
+/* returns the number of recorded events */
+uint32_t
+lvgl_record_stop (void);
+
+const lvgl_record_event_t *
+lvgl_record_get (uint32_t *count);
+
+/* print the recording as a C array on the UART, to be compiled into a
+ * firmware or simulator build and passed to lvgl_replay_start(); build
+ * this file with LVGL_RECORD and LVGL_RECORD_HOST on a simulator and call
+ * lvgl_replay_read() from its pointer read callback */
+void
+lvgl_record_dump (void);
+
+/* feed events through the touchscreen input device with their original
+ * timing, the panel is ignored until done */
+void
+lvgl_replay_start (const lvgl_record_event_t *events, uint32_t count,
+                   lvgl_replay_done_cb_t done_cb);
+
+void
+lvgl_replay_stop (void);
+
+/* hooks for the read callback: an event is due, take it / log the result */
+bool
+lvgl_replay_pending (void);
+
+/* ms until the next replayed event is due, LV_NO_TIMER_READY if none */
+uint32_t
+lvgl_replay_wait (void);
+
+bool
+lvgl_replay_read (lv_indev_data_t *data);
+
+void
+lvgl_record_read (const lv_indev_data_t *data);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_RECORD_H */
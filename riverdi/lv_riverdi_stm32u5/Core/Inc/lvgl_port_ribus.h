@@ -0,0 +1,68 @@
+#ifndef __LVGL_PORT_RIBUS_H
+#define __LVGL_PORT_RIBUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* secondary Riverdi EVE display on the RiBUS connector (SPI1, R_CS, R_RST);
+ * timings are for the 5-inch 800x480 EVE4 modules, adjust for others */
+#define RIBUS_HOR_RES       800
+#define RIBUS_VER_RES       480
+#define RIBUS_HCYCLE        816
+#define RIBUS_HOFFSET       8
+#define RIBUS_HSYNC0        0
+#define RIBUS_HSYNC1        4
+#define RIBUS_VCYCLE        496
+#define RIBUS_VOFFSET       8
+#define RIBUS_VSYNC0        0
+#define RIBUS_VSYNC1        4
+#define RIBUS_PCLK          3
+#define RIBUS_PCLK_POL      1
+#define RIBUS_SWIZZLE       0
+#define RIBUS_CSPREAD       0
+
+/* the secondary panel is mostly static: refresh it less often than the
+ * primary so it does not eat into the primary's frame time */
+#define RIBUS_REFR_PERIOD   100
+
+/* draw buffer of its own, so a slow SPI transfer never holds up the
+ * primary display; a full-width band of this many lines */
+#define RIBUS_BUF_LINES     40
+
+/* SPI1 transmit runs on this GPDMA channel */
+#define RIBUS_DMA_CHANNEL   GPDMA1_Channel7
+#define RIBUS_DMA_IRQn      GPDMA1_Channel7_IRQn
+
+/* the EVE boots in up to 300 ms, its reset in a few ms more */
+#define RIBUS_BOOT_TIMEOUT  300
+#define RIBUS_RESET_TIMEOUT 50
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* returns NULL when no EVE display answers on RiBUS; an empty connector
+ * is detected within the power cycle, about 40 ms */
+lv_display_t *
+lvgl_ribus_display_init (void);
+
+/* GPDMA channel interrupt, see stm32u5xx_it.c */
+void
+lvgl_ribus_dma_irq (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_RIBUS_H */
@@ -0,0 +1,48 @@
+#ifndef __LVGL_PORT_SLEEP_H
+#define __LVGL_PORT_SLEEP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* LPTIM2 counts LSE: 16-bit period, ~2 s per sleep at most */
+#define LVGL_SLEEP_LPTIM          hlptim2
+#define LVGL_SLEEP_LPTIM_HZ       LSE_VALUE
+#define LVGL_SLEEP_MAX_COUNTS     0xFFFFU
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* take LPTIM2 over as FreeRTOS tickless idle wake-up timer, before the
+ * scheduler starts */
+void
+lvgl_sleep_init (void);
+
+/* idle periods enter Stop 1 instead of Sleep; LTDC, DMA2D and the
+ * peripherals used for transfers stop with the clocks, so allow it only
+ * while the display is off and no transfer is running, as
+ * lvgl_display_idle_process() does */
+void
+lvgl_sleep_allow_stop (bool allow);
+
+/* LPTIM2 interrupt, only wakes the core */
+void
+lvgl_sleep_lptim_irq (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_SLEEP_H */
@@ -0,0 +1,59 @@
+#ifndef __LVGL_PORT_TASK_H
+#define __LVGL_PORT_TASK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define LVGL_TASK_STACK_SIZE    (4 * 1024)
+
+/* thread flag that ends the LVGL task's sleep */
+#define LVGL_TASK_FLAG_WAKE     0x0001U
+
+/* run the following statement or block with the LVGL lock held, from any
+ * task; leaving it with return, break or goto skips the unlock. Prepare
+ * the data before, keep only the lv_ calls inside:
+ *
+ *   lv_snprintf(buf, sizeof(buf), "%d C", read_temperature());
+ *   LVGL_LOCKED()
+ *     lv_label_set_text(label, buf);
+ */
+#define LVGL_LOCKED() \
+  for (int lvgl_locked_ = (lvgl_lock(), 1); lvgl_locked_; lvgl_locked_ = (lvgl_unlock(), 0))
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* create the thread running lv_timer_handler() */
+void
+lvgl_task_create (void);
+
+/* run the LVGL task now instead of at its next timer deadline: new touch
+ * data, a finished flush, application data to show. Thread or ISR */
+void
+lvgl_task_wake (void);
+
+/* lv_lock()/lv_unlock() for tasks other than the LVGL one; the unlock
+ * wakes the LVGL task to render the change. Not from interrupts */
+void
+lvgl_lock (void);
+
+void
+lvgl_unlock (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_TASK_H */
@@ -0,0 +1,54 @@
+#ifndef __LVGL_PORT_TICK_H
+#define __LVGL_PORT_TICK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* 32-bit timer left free-running by CubeMX */
+#define LVGL_TICK_TIM         htim5
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* run the timer at 1 MHz and hand it to LVGL as its tick, after lv_init() */
+void
+lvgl_tick_init (void);
+
+/* free-running microseconds for profiling; differences stay valid across
+ * the 32-bit wrap (~71 min). Thread or ISR */
+uint32_t
+lvgl_tick_get_us (void);
+
+/* account for time the timer was halted, i.e. in Stop mode */
+void
+lvgl_tick_add_us (uint32_t us);
+
+/* the real time in ms, also while frozen */
+uint32_t
+lvgl_tick_get_ms (void);
+
+/* make lv_tick_get() return ms until lvgl_tick_thaw(), e.g. to run the
+ * animations at the time their frame is shown. LVGL task only */
+void
+lvgl_tick_freeze (uint32_t ms);
+
+void
+lvgl_tick_thaw (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_TICK_H */
@@ -18,6 +18,9 @@ extern "C" {
 void
 lvgl_touchscreen_init (void);
 
+uint32_t
+lvgl_touchscreen_process (void);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
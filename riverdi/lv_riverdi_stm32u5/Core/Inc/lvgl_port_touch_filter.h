@@ -0,0 +1,70 @@
+#ifndef __LVGL_PORT_TOUCH_FILTER_H
+#define __LVGL_PORT_TOUCH_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* 1: smooth the samples, 0 (default): LVGL gets the raw samples */
+#ifndef LVGL_TOUCH_FILTER
+#define LVGL_TOUCH_FILTER             0
+#endif
+
+/* One Euro filter: a low-pass whose cutoff rises with the finger speed.
+ * Lower MIN_CUTOFF for less jitter at rest, raise BETA for less lag on
+ * fast drags; D_CUTOFF smooths the speed estimate itself */
+#define LVGL_TOUCH_MIN_CUTOFF         1.0f      /* Hz */
+#define LVGL_TOUCH_BETA               0.02f
+#define LVGL_TOUCH_D_CUTOFF           1.0f      /* Hz */
+
+/* the filtered point is extrapolated along the filtered velocity by the
+ * measured touch-to-display latency, up to this horizon */
+#ifndef LVGL_TOUCH_PREDICT
+#define LVGL_TOUCH_PREDICT            0
+#endif
+#define LVGL_TOUCH_PREDICT_MAX_MS     48
+
+/* added to the measured latency: from the end of the flush to the middle
+ * of the panel scan-out at ~60 Hz */
+#define LVGL_TOUCH_SCANOUT_MS         8
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* start of a new touch: forget the previous trajectory */
+void
+lvgl_touch_filter_reset (void);
+
+/* filter a pressed sample in place; timestamp in ms at the interrupt */
+void
+lvgl_touch_filter_apply (int32_t *x, int32_t *y, uint32_t timestamp);
+
+/* a frame containing the last applied sample finished flushing;
+ * callable from interrupt context */
+void
+lvgl_touch_filter_presented (uint32_t now);
+
+/* runtime switch, starts as LVGL_TOUCH_FILTER */
+void
+lvgl_touch_filter_enable (bool enable);
+
+/* averaged touch-to-display latency in ms */
+uint32_t
+lvgl_touch_filter_get_latency (void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_TOUCH_FILTER_H */
@@ -0,0 +1,66 @@
+#ifndef __LVGL_PORT_WORKER_H
+#define __LVGL_PORT_WORKER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* one is enough for CPU-bound jobs on a single core, more only help
+ * jobs that block (external flash, file system) */
+#define LVGL_WORKER_COUNT         1
+
+/* PNG and JPEG decoding run on the worker's stack */
+#define LVGL_WORKER_STACK_SIZE    (8 * 1024)
+#define LVGL_WORKER_QUEUE_LEN     8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef void (*lvgl_worker_cb_t) (void * user_data);
+
+/* decoded image, NULL when the decoder does not produce a whole buffer;
+ * owned by the callback, free it with lv_draw_buf_destroy() */
+typedef void (*lvgl_worker_image_cb_t) (lv_draw_buf_t * buf, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/* start the worker tasks below the LVGL task's priority, after lv_init() */
+void
+lvgl_worker_init (void);
+
+/*
+ * Run work(user_data) on a worker task, then done(user_data) on the LVGL
+ * task. work must not call LVGL except for lv_malloc()/lv_draw_buf_*(),
+ * or inside LVGL_LOCKED(); done may update widgets, e.g. replace the
+ * placeholder shown meanwhile. Returns false when the queue is full.
+ * Any task, not from interrupts
+ */
+bool
+lvgl_worker_submit (lvgl_worker_cb_t work, lvgl_worker_cb_t done,
+                    void * user_data);
+
+/* decode src into a new draw buffer, e.g. for lv_image_set_src(img, buf)
+ * once done; the LVGL lock is held only to pick the decoder, the decode
+ * itself runs alongside rendering */
+bool
+lvgl_worker_image_decode (const void * src, lvgl_worker_image_cb_t done,
+                          void * user_data);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /* __LVGL_PORT_WORKER_H */
@@ -59,6 +59,11 @@ void GPU2D_IRQHandler(void);
 void GPU2D_ER_IRQHandler(void);
 void LTDC_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void SPI1_IRQHandler(void);
+void GPDMA1_Channel7_IRQHandler(void);
+void I2C1_EV_IRQHandler(void);
+void I2C1_ER_IRQHandler(void);
+void LPTIM2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
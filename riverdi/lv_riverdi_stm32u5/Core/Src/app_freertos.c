@@ -25,6 +25,7 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "lvgl/lvgl.h"
+#include "lvgl_port_task.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -44,19 +45,6 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* USER CODE BEGIN Variables */
-osThreadId_t lvglTickHandle;
-const osThreadAttr_t lvglTick_attributes = {
-  .name = "lvglTick",
-  .priority = (osPriority_t) osPriorityNormal,
-  .stack_size = 4* 1024
-};
-
-osThreadId_t lvglTimerHandle;
-const osThreadAttr_t lvglTimer_attributes = {
-  .name = "lvglTimer",
-  .priority = (osPriority_t) osPriorityNormal,
-  .stack_size = 4* 1024
-};
 /* USER CODE END Variables */
 /* Definitions for defaultTask */
 osThreadId_t defaultTaskHandle;
@@ -68,8 +56,6 @@ const osThreadAttr_t defaultTask_attributes = {
 
 /* Private function prototypes -----------------------------------------------*/
 /* USER CODE BEGIN FunctionPrototypes */
-void LVGLTimer(void *argument);
-void LVGLTick(void *argument);
 /* USER CODE END FunctionPrototypes */
 
 void StartDefaultTask(void *argument);
@@ -151,8 +137,7 @@ void MX_FREERTOS_Init(void) {
 
   /* USER CODE BEGIN RTOS_THREADS */
   /* add threads, ... */
-  lvglTickHandle = osThreadNew(LVGLTick, NULL, &lvglTick_attributes);
-  lvglTimerHandle = osThreadNew(LVGLTimer, NULL, &lvglTimer_attributes);
+  lvgl_task_create();
   /* USER CODE END RTOS_THREADS */
 
   /* USER CODE BEGIN RTOS_EVENTS */
@@ -180,23 +165,5 @@ void StartDefaultTask(void *argument)
 
 /* Private application code --------------------------------------------------*/
 /* USER CODE BEGIN Application */
-/* LVGL timer for tasks */
-void LVGLTimer(void *argument)
-{
-  for(;;)
-  {
-    lv_timer_handler();
-    //osDelay(20);
-  }
-}
-/* LVGL tick source */
-void LVGLTick(void *argument)
-{
-  for(;;)
-  {
-    lv_tick_inc(10);
-    osDelay(10);
-  }
-}
 /* USER CODE END Application */
 
@@ -0,0 +1,286 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_arena.h"
+#include "lvgl_port_heap.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define ALIGN_SIZE        portBYTE_ALIGNMENT
+#define ROUND_UP(x)       (((x) + ALIGN_SIZE - 1) & ~(size_t)(ALIGN_SIZE - 1))
+
+/* every allocation is preceded by its size, for lv_realloc() */
+#define PREFIX_SIZE       ROUND_UP(sizeof(uint32_t))
+#define PREFIX(p)         (*(uint32_t *)((uint8_t *)(p) - PREFIX_SIZE))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/* at the start of the block, the allocations follow */
+typedef struct
+{
+  uint8_t * top;        /* next free byte */
+  uint8_t * end;
+  uint32_t live;        /* allocations not freed yet */
+  bool deleted;         /* the screen is gone, release at live == 0 */
+} arena_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static int32_t
+find (void *p);
+
+static arena_t *
+retire (int32_t i);
+
+static void
+screen_delete_cb (lv_event_t *e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/* searched on every lv_free(), a slot is NULL when unused */
+static arena_t * arenas[LVGL_ARENA_MAX];
+
+/* filled by the owner task only */
+static arena_t * building;
+static TaskHandle_t owner;
+static uint32_t suspended;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+bool
+lvgl_arena_begin (size_t size)
+{
+  arena_t * a;
+  uint32_t i;
+
+  LV_ASSERT(building == NULL);
+
+  for (i = 0; i < LVGL_ARENA_MAX && arenas[i] != NULL; i++);
+  if (i == LVGL_ARENA_MAX)
+    return false;
+
+  a = lvgl_heap_alloc(ROUND_UP(sizeof(arena_t)) + ROUND_UP(size));
+  if (a == NULL)
+    return false;
+
+  a->top = (uint8_t *)a + ROUND_UP(sizeof(arena_t));
+  a->end = a->top + ROUND_UP(size);
+  a->live = 0;
+  a->deleted = false;
+
+  vTaskSuspendAll();
+  arenas[i] = a;
+  xTaskResumeAll();
+
+  owner = xTaskGetCurrentTaskHandle();
+  suspended = 0;
+  building = a;
+
+  return true;
+}
+
+size_t
+lvgl_arena_end (lv_obj_t * scr)
+{
+  arena_t * a = building;
+  arena_t * release = NULL;
+  size_t used;
+
+  if (a == NULL)
+    return 0;
+
+  /* from here on, including the event below, from the heap */
+  building = NULL;
+  used = a->top - ((uint8_t *)a + ROUND_UP(sizeof(arena_t)));
+
+  if (scr != NULL)
+    lv_obj_add_event_cb(scr, screen_delete_cb, LV_EVENT_DELETE, a);
+  else
+  {
+    /* nothing to wait for, release as soon as all is freed */
+    vTaskSuspendAll();
+    a->deleted = true;
+    if (a->live == 0)
+      release = retire(find(a->end - 1));
+    xTaskResumeAll();
+  }
+
+  if (release != NULL)
+    lvgl_heap_free(release);
+
+  return used;
+}
+
+void
+lvgl_arena_suspend (void)
+{
+  suspended++;
+}
+
+void
+lvgl_arena_resume (void)
+{
+  LV_ASSERT(suspended > 0);
+  suspended--;
+}
+
+void *
+lvgl_arena_alloc (size_t size)
+{
+  arena_t * a = building;
+  size_t need = PREFIX_SIZE + ROUND_UP(size);
+  uint8_t * p = NULL;
+
+  /* other tasks, e.g. the worker, always use the heap */
+  if (a == NULL || suspended || xTaskGetCurrentTaskHandle() != owner)
+    return NULL;
+
+  vTaskSuspendAll();
+  if ((size_t)(a->end - a->top) >= need)
+  {
+    p = a->top + PREFIX_SIZE;
+    PREFIX(p) = size;
+    a->top += need;
+    a->live++;
+  }
+  xTaskResumeAll();
+
+  return p;
+}
+
+bool
+lvgl_arena_realloc (void **p, size_t size)
+{
+  arena_t * a;
+  uint8_t * old = *p;
+  void * n;
+  int32_t i;
+
+  vTaskSuspendAll();
+  i = find(old);
+  a = i < 0 ? NULL : arenas[i];
+
+  /* the last allocation of the arena being built grows in place */
+  if (a != NULL && a == building && !suspended &&
+      xTaskGetCurrentTaskHandle() == owner &&
+      old + ROUND_UP(PREFIX(old)) == a->top &&
+      (size_t)(a->end - old) >= ROUND_UP(size))
+  {
+    PREFIX(old) = size;
+    a->top = old + ROUND_UP(size);
+    xTaskResumeAll();
+    return true;
+  }
+  xTaskResumeAll();
+
+  if (a == NULL)
+    return false;
+
+  n = lvgl_arena_alloc(size);
+  if (n == NULL)
+    n = lvgl_heap_alloc(size);
+
+  /* on failure the old allocation stays valid, as with realloc() */
+  if (n != NULL)
+  {
+    memcpy(n, old, LV_MIN(PREFIX(old), size));
+    lvgl_arena_free(old);
+  }
+
+  *p = n;
+  return true;
+}
+
+bool
+lvgl_arena_free (void *p)
+{
+  arena_t * a;
+  arena_t * release = NULL;
+  int32_t i;
+
+  vTaskSuspendAll();
+  i = find(p);
+  if (i < 0)
+  {
+    xTaskResumeAll();
+    return false;
+  }
+
+  a = arenas[i];
+
+  /* the last allocation of the arena being built is given back, so
+   * temporaries while building do not use it up */
+  if (a == building && (uint8_t *)p + ROUND_UP(PREFIX(p)) == a->top)
+    a->top = (uint8_t *)p - PREFIX_SIZE;
+
+  if (--a->live == 0 && a->deleted)
+    release = retire(i);
+  xTaskResumeAll();
+
+  /* one free for all the screen's allocations */
+  if (release != NULL)
+    lvgl_heap_free(release);
+
+  return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* the arena p was allocated from, -1 for the heap; with the scheduler
+ * suspended */
+static int32_t
+find (void *p)
+{
+  int32_t i;
+
+  for (i = 0; i < LVGL_ARENA_MAX; i++)
+    if (arenas[i] != NULL &&
+        (uint8_t *)p > (uint8_t *)arenas[i] && (uint8_t *)p < arenas[i]->end)
+      return i;
+
+  return -1;
+}
+
+/* take an arena off the table, the caller frees it after resuming */
+static arena_t *
+retire (int32_t i)
+{
+  arena_t * a = arenas[i];
+
+  arenas[i] = NULL;
+  return a;
+}
+
+/* LVGL frees the screen's children and the screen itself after this, the
+ * last of those frees releases the arena */
+static void
+screen_delete_cb (lv_event_t *e)
+{
+  arena_t * a = lv_event_get_user_data(e);
+  arena_t * release = NULL;
+
+  vTaskSuspendAll();
+  a->deleted = true;
+  if (a->live == 0)
+    release = retire(find(a->end - 1));
+  xTaskResumeAll();
+
+  if (release != NULL)
+    lvgl_heap_free(release);
+}
@@ -0,0 +1,312 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_cache.h"
+#include "main.h"
+#include "dcache.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define DIRTY_SLOTS    8
+
+/* status polls before giving up on a maintenance command with interrupts
+ * masked, well above a full clean of the 32 KB cache at 160 MHz */
+#define POLL_LIMIT     1000000U
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  uint32_t start;
+  uint32_t end;
+} cache_range_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static int cache_clip (const void *, size_t, cache_range_t *);
+static void cache_clean_range (DCACHE_HandleTypeDef *, const cache_range_t *);
+static void cache_invalidate_range (DCACHE_HandleTypeDef *, const cache_range_t *);
+static void cache_flush_all (DCACHE_HandleTypeDef *);
+static bool cache_wait (DCACHE_TypeDef *, uint32_t, uint32_t);
+#ifdef DEBUG
+static void dirty_clear (const cache_range_t *);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+#ifdef DEBUG
+static cache_range_t dirty[DIRTY_SLOTS];
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_cache_clean (const void * addr, size_t size)
+{
+  cache_range_t r;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  cache_clean_range(&hdcache1, &r);
+}
+
+void
+lvgl_cache_invalidate (const void * addr, size_t size)
+{
+  cache_range_t r;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  cache_invalidate_range(&hdcache1, &r);
+}
+
+void
+lvgl_cache_clean_invalidate (const void * addr, size_t size)
+{
+  cache_range_t r;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  if (r.end - r.start >= LVGL_CACHE_FULL_THRESHOLD)
+    cache_flush_all(&hdcache1);
+  else
+    HAL_DCACHE_CleanInvalidByAddr(&hdcache1, (const uint32_t *)r.start,
+                                  r.end - r.start);
+#ifdef DEBUG
+  dirty_clear(&r);
+#endif
+}
+
+void
+lvgl_cache_to_master (lvgl_cache_master_t master, const void * addr, size_t size)
+{
+  cache_range_t r;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  /* push CPU writes out to memory */
+  cache_clean_range(&hdcache1, &r);
+
+  /* GPU2D reads through DCACHE2, drop whatever it still holds */
+  if (master == LVGL_CACHE_MASTER_GPU2D)
+    cache_invalidate_range(&hdcache2, &r);
+}
+
+void
+lvgl_cache_from_master (lvgl_cache_master_t master, const void * addr, size_t size)
+{
+  cache_range_t r;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  /* GPU2D writes may still sit in DCACHE2 */
+  if (master == LVGL_CACHE_MASTER_GPU2D)
+    cache_clean_range(&hdcache2, &r);
+
+  cache_invalidate_range(&hdcache1, &r);
+}
+
+#ifdef DEBUG
+void
+lvgl_cache_mark_dirty (const void * addr, size_t size)
+{
+  cache_range_t r;
+  uint32_t i;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  for (i = 0; i < DIRTY_SLOTS; i++)
+  {
+    /* merge with an overlapping range or take a free slot */
+    if (dirty[i].start == dirty[i].end ||
+        (r.start <= dirty[i].end && dirty[i].start <= r.end))
+    {
+      if (dirty[i].start != dirty[i].end)
+      {
+        r.start = LV_MIN(r.start, dirty[i].start);
+        r.end = LV_MAX(r.end, dirty[i].end);
+      }
+      dirty[i] = r;
+      return;
+    }
+  }
+
+  /* table full: keep the widest view rather than lose track */
+  dirty[0].start = LV_MIN(dirty[0].start, r.start);
+  dirty[0].end = LV_MAX(dirty[0].end, r.end);
+}
+
+void
+lvgl_cache_check (const void * addr, size_t size)
+{
+  cache_range_t r;
+  uint32_t i;
+
+  if (!cache_clip(addr, size, &r))
+    return;
+
+  for (i = 0; i < DIRTY_SLOTS; i++)
+  {
+    if (dirty[i].start != dirty[i].end &&
+        r.start < dirty[i].end && dirty[i].start < r.end)
+    {
+      LV_LOG_ERROR("dirty lines 0x%08lx-0x%08lx handed to a DMA master",
+                   (unsigned long)LV_MAX(r.start, dirty[i].start),
+                   (unsigned long)LV_MIN(r.end, dirty[i].end));
+      LV_ASSERT(0);
+    }
+  }
+}
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* align to cache lines and drop anything outside the cached window */
+static int
+cache_clip (const void * addr, size_t size, cache_range_t * r)
+{
+  uint32_t start = (uint32_t)addr;
+  uint32_t end = start + size;
+
+  if (size == 0 || end <= LVGL_CACHE_REGION_START || start >= LVGL_CACHE_REGION_END)
+    return 0;
+
+  start = LV_MAX(start, LVGL_CACHE_REGION_START);
+  end = LV_MIN(end, LVGL_CACHE_REGION_END);
+
+  r->start = start & ~(LVGL_CACHE_LINE_SIZE - 1U);
+  r->end = (end + LVGL_CACHE_LINE_SIZE - 1U) & ~(LVGL_CACHE_LINE_SIZE - 1U);
+  return 1;
+}
+
+static void
+cache_clean_range (DCACHE_HandleTypeDef * hdcache, const cache_range_t * r)
+{
+  static const cache_range_t all = { LVGL_CACHE_REGION_START, LVGL_CACHE_REGION_END };
+
+  /* there is no whole-cache clean command; one range command over the
+   * full window replaces walking a large buffer */
+  if (r->end - r->start >= LVGL_CACHE_FULL_THRESHOLD)
+    r = &all;
+
+  HAL_DCACHE_CleanByAddr(hdcache, (const uint32_t *)r->start, r->end - r->start);
+#ifdef DEBUG
+  if (hdcache == &hdcache1)
+    dirty_clear(r);
+#endif
+}
+
+static void
+cache_invalidate_range (DCACHE_HandleTypeDef * hdcache, const cache_range_t * r)
+{
+  if (r->end - r->start >= LVGL_CACHE_FULL_THRESHOLD)
+  {
+    cache_flush_all(hdcache);
+    return;
+  }
+
+  /* cache_clip() rounded outwards, so the first and last line may hold
+   * someone else's dirty data: write them back instead of dropping them */
+  HAL_DCACHE_CleanInvalidByAddr(hdcache, (const uint32_t *)r->start,
+                                LVGL_CACHE_LINE_SIZE);
+  if (r->end - r->start > LVGL_CACHE_LINE_SIZE)
+    HAL_DCACHE_CleanInvalidByAddr(hdcache,
+                                  (const uint32_t *)(r->end - LVGL_CACHE_LINE_SIZE),
+                                  LVGL_CACHE_LINE_SIZE);
+  if (r->end - r->start > 2U * LVGL_CACHE_LINE_SIZE)
+    HAL_DCACHE_InvalidateByAddr(hdcache,
+                                (const uint32_t *)(r->start + LVGL_CACHE_LINE_SIZE),
+                                r->end - r->start - 2U * LVGL_CACHE_LINE_SIZE);
+}
+
+/* full invalidate discards dirty lines, so clean everything first and keep
+ * interrupts out so nothing gets dirtied in between; the HAL would poll
+ * with a HAL_GetTick() timeout, which stands still here, so drive the
+ * registers and poll a bounded number of times */
+static void
+cache_flush_all (DCACHE_HandleTypeDef * hdcache)
+{
+  DCACHE_TypeDef * dc = hdcache->Instance;
+  uint32_t primask = __get_PRIMASK();
+  bool ok;
+
+  __disable_irq();
+  ok = cache_wait(dc, DCACHE_SR_BUSYCMDF | DCACHE_SR_BUSYF, 0);
+  if (ok)
+  {
+    WRITE_REG(dc->FCR, DCACHE_FCR_CBSYENDF | DCACHE_FCR_CCMDENDF);
+    WRITE_REG(dc->CMDRSADDRR, LVGL_CACHE_REGION_START);
+    WRITE_REG(dc->CMDREADDRR, LVGL_CACHE_REGION_END - 1U);
+    MODIFY_REG(dc->CR, DCACHE_CR_CACHECMD, DCACHE_CR_CACHECMD_0);
+    SET_BIT(dc->CR, DCACHE_CR_STARTCMD);
+    ok = cache_wait(dc, DCACHE_SR_CMDENDF, DCACHE_SR_CMDENDF);
+  }
+  if (ok)
+  {
+    SET_BIT(dc->CR, DCACHE_CR_CACHEINV);
+    ok = cache_wait(dc, DCACHE_SR_BUSYF, 0);
+  }
+  WRITE_REG(dc->FCR, DCACHE_FCR_CBSYENDF | DCACHE_FCR_CCMDENDF);
+  __set_PRIMASK(primask);
+
+  if (!ok)
+    LV_LOG_ERROR("D-cache clean/invalidate timed out");
+#ifdef DEBUG
+  if (hdcache == &hdcache1)
+    lv_memzero(dirty, sizeof(dirty));
+#endif
+}
+
+/* true once the masked status bits read value */
+static bool
+cache_wait (DCACHE_TypeDef * dc, uint32_t mask, uint32_t value)
+{
+  uint32_t n;
+
+  for (n = 0; n < POLL_LIMIT; n++)
+    if ((READ_REG(dc->SR) & mask) == value)
+      return true;
+
+  return false;
+}
+
+#ifdef DEBUG
+static void
+dirty_clear (const cache_range_t * r)
+{
+  uint32_t i;
+
+  for (i = 0; i < DIRTY_SLOTS; i++)
+  {
+    if (dirty[i].start == dirty[i].end)
+      continue;
+
+    if (r->start <= dirty[i].start && dirty[i].end <= r->end)
+      dirty[i].start = dirty[i].end = 0;
+    else if (r->start <= dirty[i].start && r->end > dirty[i].start)
+      dirty[i].start = r->end;
+    else if (r->end >= dirty[i].end && r->start < dirty[i].end)
+      dirty[i].end = r->start;
+  }
+}
+#endif
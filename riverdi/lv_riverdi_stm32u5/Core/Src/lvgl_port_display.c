@@ -3,6 +3,13 @@
  *********************/
 
 #include "lvgl_port_display.h"
+#include "lvgl_port_cache.h"
+#include "lvgl_port_dma2d.h"
+#include "lvgl_port_touch_filter.h"
+#include "lvgl_port_latency.h"
+#include "lvgl_port_task.h"
+#include "lvgl_port_present.h"
+#include "lvgl_port_sleep.h"
 #include "main.h"
 #include "ltdc.h"
 #include "dma2d.h"
@@ -12,13 +19,22 @@
  **********************/
 
 static void disp_flush (lv_display_t *, const lv_area_t *, uint8_t *);
-static void disp_flush_complete (DMA2D_HandleTypeDef*);
+static void disp_flush_complete (void *, bool);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static lv_display_t * disp;
-static __attribute__((aligned(32))) uint8_t buf_1[MY_DISP_HOR_RES * MY_DISP_VER_RES * 2];
+static LV_ATTRIBUTE_DMA __attribute__((aligned(32))) uint8_t buf_1[MY_DISP_HOR_RES * MY_DISP_VER_RES * 2];
+static volatile bool vsync_armed;
+static volatile bool vsync_pending;
+static volatile uint32_t frame_divider = 1;
+static lv_area_t flush_area;
+static const uint8_t * flush_px_map;
+static uint32_t frame_count;
+#if LVGL_DISPLAY_OFF_MS
+static bool display_off;
+#endif
 
 /**********************
  *   GLOBAL FUNCTIONS
@@ -32,9 +48,126 @@ void lvgl_display_init (void)
 	lv_display_set_buffers(disp, buf_1, NULL, sizeof(buf_1), LV_DISPLAY_RENDER_MODE_PARTIAL);
 	lv_display_set_flush_cb(disp, disp_flush);
 
-	/* interrupt callback for DMA2D transfer */
-	hdma2d.XferCpltCallback = disp_flush_complete;
+	/* the CPU renders into buf_1 from here on */
+	LVGL_CACHE_MARK_DIRTY(buf_1, sizeof(buf_1));
 
+#if LVGL_VSYNC_REFRESH
+	/* lvgl_display_vsync_process() refreshes on the LTDC timing */
+	lv_timer_set_period(lv_display_get_refr_timer(disp), LVGL_VSYNC_FALLBACK_MS);
+	/* animations are timed to the vertical blanking too */
+	lvgl_present_init();
+#endif
+}
+
+void
+lvgl_display_vblank_request (void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  /* the HAL call is not reentrant: the task and the flush completion
+   * both request it */
+  __disable_irq();
+  HAL_LTDC_ProgramLineEvent(&hltdc, hltdc.Init.AccumulatedActiveH + 1);
+  __set_PRIMASK(primask);
+}
+
+void
+lvgl_display_vsync_process (void)
+{
+#if LVGL_VSYNC_REFRESH
+  lv_timer_t * timer = lv_display_get_refr_timer(disp);
+
+  if (vsync_pending)
+  {
+    vsync_pending = false;
+    /* animations at the time this frame is shown, then render it */
+    lvgl_present_anim_refresh();
+    _lv_display_refr_timer(timer);
+  }
+
+  /* the fallback period starts with the wait for the line event, not
+   * with the last refresh, which may be long ago */
+  if (!vsync_armed)
+  {
+    lv_timer_reset(timer);
+    lv_timer_reset(lv_anim_get_timer());
+  }
+
+  /* invalidating an area resumes the refresh timer, a running animation
+   * invalidates at the next frame; there is a single frame buffer, so
+   * the flush should land while the panel is blanked */
+  if (!vsync_armed && (!timer->paused || !lv_anim_get_timer()->paused))
+  {
+    vsync_armed = true;
+    lvgl_display_vblank_request();
+  }
+#endif
+}
+
+void
+lvgl_display_set_frame_divider (uint32_t n)
+{
+  frame_divider = LV_MAX(n, 1);
+}
+
+uint32_t
+lvgl_display_idle_process (void)
+{
+#if LVGL_DISPLAY_OFF_MS
+  uint32_t inactive = lv_display_get_inactive_time(disp);
+
+  if (display_off)
+  {
+    /* input since: the frame buffer survived Stop, just scan it out */
+    if (inactive < LVGL_DISPLAY_OFF_MS)
+    {
+      lvgl_sleep_allow_stop(false);
+      __HAL_LTDC_ENABLE(&hltdc);
+      HAL_GPIO_WritePin(LCD_DISP_RESET_GPIO_Port, LCD_DISP_RESET_Pin, GPIO_PIN_SET);
+      display_off = false;
+    }
+    return LV_NO_TIMER_READY;
+  }
+
+  if (inactive < LVGL_DISPLAY_OFF_MS)
+    return LVGL_DISPLAY_OFF_MS - inactive;
+
+  /* the last flush lands before the clocks stop */
+  if (lvgl_dma2d_busy())
+    return 1;
+
+  HAL_GPIO_WritePin(LCD_DISP_RESET_GPIO_Port, LCD_DISP_RESET_Pin, GPIO_PIN_RESET);
+  __HAL_LTDC_DISABLE(&hltdc);
+  lvgl_sleep_allow_stop(true);
+  display_off = true;
+#endif
+
+  return LV_NO_TIMER_READY;
+}
+
+void
+HAL_LTDC_LineEventCallback (LTDC_HandleTypeDef *hltdc)
+{
+  LVGL_LATENCY_MARK(LVGL_LATENCY_VISIBLE);
+
+#if LVGL_VSYNC_REFRESH
+  lvgl_present_vblank();
+#endif
+
+  if (!vsync_armed)
+    return;
+
+  /* skipped blanking: wait for the next one */
+  if (++frame_count < frame_divider)
+  {
+    lvgl_display_vblank_request();
+    return;
+  }
+
+  frame_count = 0;
+  vsync_armed = false;
+  vsync_pending = true;
+  lvgl_task_wake();
 }
 
 /**********************
@@ -49,22 +182,65 @@ disp_flush (lv_display_t * display,
   lv_coord_t width = lv_area_get_width(area);
   lv_coord_t height = lv_area_get_height(area);
 
-  DMA2D->CR = 0x0U << DMA2D_CR_MODE_Pos;
-  DMA2D->FGPFCCR = DMA2D_INPUT_RGB565;
-  DMA2D->FGMAR = (uint32_t)px_map;
-  DMA2D->FGOR = 0;
-  DMA2D->OPFCCR = DMA2D_OUTPUT_RGB565;
-  DMA2D->OMAR = hltdc.LayerCfg[0].FBStartAdress + 2 * \
-                (area->y1 * MY_DISP_HOR_RES + area->x1);
-  DMA2D->OOR = MY_DISP_HOR_RES - width;
-  DMA2D->NLR = (width << DMA2D_NLR_PL_Pos) | (height << DMA2D_NLR_NL_Pos);
-  DMA2D->IFCR = 0x3FU;
-  DMA2D->CR |= DMA2D_CR_TCIE;
-  DMA2D->CR |= DMA2D_CR_START;
+  lvgl_dma2d_job_t job = {
+    .cr = DMA2D_M2M,
+    .fgpfccr = DMA2D_INPUT_RGB565,
+    .fgmar = (uint32_t)px_map,
+    .opfccr = DMA2D_OUTPUT_RGB565,
+    .omar = hltdc.LayerCfg[0].FBStartAdress + 2 * \
+            (area->y1 * MY_DISP_HOR_RES + area->x1),
+    .oor = MY_DISP_HOR_RES - width,
+    .nlr = (width << DMA2D_NLR_PL_Pos) | (height << DMA2D_NLR_NL_Pos),
+    .done = disp_flush_complete,
+  };
+
+  /* DMA2D must see the rendered pixels, not stale memory */
+  lvgl_cache_to_master(LVGL_CACHE_MASTER_DMA2D, px_map, width * height * 2);
+  LVGL_CACHE_CHECK(px_map, width * height * 2);
+
+  /* the queue holds at most one job per display and the decoder's,
+   * so it cannot be full here */
+  if (lv_display_flush_is_last(display))
+    LVGL_LATENCY_MARK(LVGL_LATENCY_RENDER);
+
+  /* for the CPU copy if the DMA2D fails */
+  flush_area = *area;
+  flush_px_map = px_map;
+
+  lvgl_dma2d_submit(&job);
 }
 
 static void
-disp_flush_complete (DMA2D_HandleTypeDef *hdma2d)
+disp_flush_complete (void * user_data, bool ok)
 {
+  /* a transfer or configuration error left the area unwritten: copy it
+   * with the CPU rather than presenting a stale frame */
+  if (!ok)
+  {
+    uint32_t row = lv_area_get_width(&flush_area) * 2;
+    uint8_t * fb = (uint8_t *)hltdc.LayerCfg[0].FBStartAdress + 2 * \
+                   (flush_area.y1 * MY_DISP_HOR_RES + flush_area.x1);
+    int32_t y;
+
+    for (y = flush_area.y1; y <= flush_area.y2; y++)
+    {
+      lv_memcpy(fb, flush_px_map, row);
+      fb += MY_DISP_HOR_RES * 2;
+      flush_px_map += row;
+    }
+  }
+
+  /* the touch filter predicts ahead by the measured latency */
+  if (lv_display_flush_is_last(disp))
+  {
+    LVGL_LATENCY_MARK(LVGL_LATENCY_FLUSH);
+    lvgl_touch_filter_presented(HAL_GetTick());
+#if LVGL_VSYNC_REFRESH
+    lvgl_present_flushed();
+#endif
+  }
+
+  LVGL_CACHE_MARK_DIRTY(buf_1, sizeof(buf_1));
   lv_display_flush_ready(disp);
+  lvgl_task_wake();
 }
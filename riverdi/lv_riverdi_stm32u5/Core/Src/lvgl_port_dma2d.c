@@ -0,0 +1,194 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_dma2d.h"
+#include "main.h"
+#include "dma2d.h"
+#include "cmsis_os2.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define DMA2D_IRQ_ENABLES    (DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  osThreadId_t thread;
+  volatile bool ok;
+} run_state_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void job_start (const lvgl_dma2d_job_t *);
+static void job_finish (bool);
+static void dma2d_xfer_complete (DMA2D_HandleTypeDef *);
+static void dma2d_xfer_error (DMA2D_HandleTypeDef *);
+static void run_done (void *, bool);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static lvgl_dma2d_job_t queue[LVGL_DMA2D_QUEUE_LEN];
+static volatile uint32_t head;      /* next free slot */
+static volatile uint32_t tail;      /* running job */
+static volatile bool running;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_dma2d_init (void)
+{
+  head = tail = 0;
+  running = false;
+
+  hdma2d.XferCpltCallback = dma2d_xfer_complete;
+  hdma2d.XferErrorCallback = dma2d_xfer_error;
+}
+
+bool
+lvgl_dma2d_submit (const lvgl_dma2d_job_t * job)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t next;
+
+  __disable_irq();
+
+  next = (head + 1) % LVGL_DMA2D_QUEUE_LEN;
+  if (next == tail)
+  {
+    __set_PRIMASK(primask);
+    return false;
+  }
+
+  queue[head] = *job;
+  head = next;
+
+  if (!running)
+    job_start(&queue[tail]);
+
+  __set_PRIMASK(primask);
+  return true;
+}
+
+bool
+lvgl_dma2d_run (const lvgl_dma2d_job_t * job)
+{
+  run_state_t state = { osThreadGetId(), false };
+  lvgl_dma2d_job_t j = *job;
+
+  j.done = run_done;
+  j.user_data = &state;
+
+  /* a full queue drains within a few flushes */
+  while (!lvgl_dma2d_submit(&j))
+    osDelay(1);
+
+  /* other tasks, e.g. a lower priority one, run meanwhile */
+  osThreadFlagsWait(LVGL_DMA2D_FLAG_DONE, osFlagsWaitAny, osWaitForever);
+
+  return state.ok;
+}
+
+bool
+lvgl_dma2d_busy (void)
+{
+  return running || head != tail;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* called with interrupts masked or from the DMA2D interrupt */
+static void
+job_start (const lvgl_dma2d_job_t * job)
+{
+  running = true;
+
+  DMA2D->IFCR = 0x3FU;
+  DMA2D->FGPFCCR = job->fgpfccr;
+  DMA2D->FGCOLR = job->fgcolr;
+
+  if (job->fgcmar)
+  {
+    /* a 256 entry CLUT loads in well under a microsecond, poll it */
+    DMA2D->FGCMAR = job->fgcmar;
+    DMA2D->FGPFCCR |= DMA2D_FGPFCCR_START;
+    while (!(DMA2D->ISR & (DMA2D_ISR_CTCIF | DMA2D_ISR_CAEIF)));
+
+    if (DMA2D->ISR & DMA2D_ISR_CAEIF)
+    {
+      DMA2D->IFCR = 0x3FU;
+      job_finish(false);
+      return;
+    }
+    DMA2D->IFCR = DMA2D_IFCR_CCTCIF;
+  }
+
+  DMA2D->FGMAR = job->fgmar;
+  DMA2D->FGOR = job->fgor;
+  DMA2D->BGMAR = job->bgmar;
+  DMA2D->BGOR = job->bgor;
+  DMA2D->BGPFCCR = job->bgpfccr;
+  DMA2D->OPFCCR = job->opfccr;
+  DMA2D->OCOLR = job->ocolr;
+  DMA2D->OMAR = job->omar;
+  DMA2D->OOR = job->oor;
+  DMA2D->NLR = job->nlr;
+  DMA2D->CR = job->cr | DMA2D_IRQ_ENABLES;
+  DMA2D->CR |= DMA2D_CR_START;
+}
+
+static void
+job_finish (bool ok)
+{
+  void (*done) (void *, bool) = queue[tail].done;
+  void * user_data = queue[tail].user_data;
+
+  tail = (tail + 1) % LVGL_DMA2D_QUEUE_LEN;
+  running = false;
+
+  /* keep DMA2D busy before handing the result back */
+  if (tail != head)
+    job_start(&queue[tail]);
+
+  if (done)
+    done(user_data, ok);
+}
+
+static void
+dma2d_xfer_complete (DMA2D_HandleTypeDef *hdma2d)
+{
+  job_finish(true);
+}
+
+static void
+dma2d_xfer_error (DMA2D_HandleTypeDef *hdma2d)
+{
+  /* the HAL reports TE and CE separately; once the failed job is retired
+   * a follow-up report must not hit the next, already started job */
+  if (!running || (DMA2D->CR & DMA2D_CR_START))
+    return;
+
+  job_finish(false);
+}
+
+static void
+run_done (void * user_data, bool ok)
+{
+  run_state_t * state = user_data;
+
+  state->ok = ok;
+  osThreadFlagsSet(state->thread, LVGL_DMA2D_FLAG_DONE);
+}
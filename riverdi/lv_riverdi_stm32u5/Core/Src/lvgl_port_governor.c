@@ -0,0 +1,219 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_governor.h"
+#include "lvgl_port_display.h"
+#include "lvgl_port_present.h"
+#include "lvgl_port_tick.h"
+#include "main.h"
+#include "usart.h"
+
+#if LVGL_GOVERNOR
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* any id the other draw units do not use */
+#define DRAW_UNIT_ID      9
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+render_start_cb (lv_event_t *e);
+
+static void
+render_ready_cb (lv_event_t *e);
+
+static void
+set_level (lvgl_governor_level_t new_level, uint32_t render_us, uint32_t budget_us);
+
+static void
+level_changed_cb (void *user_data);
+
+static int32_t
+draw_evaluate (lv_draw_unit_t *draw_unit, lv_draw_task_t *task);
+
+static int32_t
+draw_dispatch (lv_draw_unit_t *draw_unit, lv_layer_t *layer);
+
+static void
+uart_print (const char *s);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static const char * const names[] = {
+  "full", "reduced: no shadows, nearest images", "minimal: no anti-aliasing, half rate"
+};
+
+static lv_display_t * disp;
+static lvgl_governor_level_t level;
+static uint32_t render_start;
+static uint32_t over;
+static uint32_t under;
+
+/* what set_level() saw, for the log */
+static uint32_t log_render_us;
+static uint32_t log_budget_us;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_governor_init (void)
+{
+  lv_draw_unit_t * unit;
+
+  disp = lv_display_get_default();
+  lv_display_add_event_cb(disp, render_start_cb, LV_EVENT_RENDER_START, NULL);
+  lv_display_add_event_cb(disp, render_ready_cb, LV_EVENT_RENDER_READY, NULL);
+
+  /* sees every draw task as it is created, takes the dropped ones */
+  unit = lv_draw_create_unit(sizeof(lv_draw_unit_t));
+  unit->evaluate_cb = draw_evaluate;
+  unit->dispatch_cb = draw_dispatch;
+}
+
+lvgl_governor_level_t
+lvgl_governor_get_level (void)
+{
+  return level;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+render_start_cb (lv_event_t *e)
+{
+  render_start = lvgl_tick_get_us();
+}
+
+static void
+render_ready_cb (lv_event_t *e)
+{
+  uint32_t render_us = lvgl_tick_get_us() - render_start;
+  uint32_t budget_us = lvgl_present_get_period_us();
+
+  if (budget_us == 0)
+    budget_us = LVGL_GOVERNOR_BUDGET_US;
+
+  if (render_us > budget_us)
+  {
+    under = 0;
+    if (++over >= LVGL_GOVERNOR_OVER_FRAMES && level < LVGL_GOVERNOR_MINIMAL)
+      set_level(level + 1, render_us, budget_us);
+  }
+  else if (render_us < budget_us * LVGL_GOVERNOR_HEADROOM_PCT / 100)
+  {
+    over = 0;
+    if (++under >= LVGL_GOVERNOR_UNDER_FRAMES && level > LVGL_GOVERNOR_FULL)
+      set_level(level - 1, render_us, budget_us);
+  }
+  else
+    over = under = 0;
+}
+
+static void
+set_level (lvgl_governor_level_t new_level, uint32_t render_us, uint32_t budget_us)
+{
+  bool minimal = new_level == LVGL_GOVERNOR_MINIMAL;
+
+  level = new_level;
+  over = under = 0;
+
+  lv_display_set_antialiasing(disp, !minimal);
+#if LVGL_VSYNC_REFRESH
+  lvgl_display_set_frame_divider(minimal ? 2 : 1);
+#else
+  lv_timer_set_period(lv_anim_get_timer(), minimal ? 2 * LV_DEF_REFR_PERIOD : LV_DEF_REFR_PERIOD);
+#endif
+
+  /* redraw and log once this refresh is over: the blocking UART write
+   * would count towards the render time measured here */
+  log_render_us = render_us;
+  log_budget_us = budget_us;
+  lv_async_call(level_changed_cb, NULL);
+}
+
+/* redraw everything at the new quality and report the change */
+static void
+level_changed_cb (void *user_data)
+{
+  char line[96];
+
+  lv_obj_invalidate(lv_display_get_screen_active(disp));
+
+  lv_snprintf(line, sizeof(line), "governor %s, render %lu us, budget %lu us\r\n",
+              names[level], log_render_us, log_budget_us);
+  uart_print(line);
+}
+
+/* called for every new draw task: shadows go to this unit, which drops
+ * them; image and layer transforms lose their bilinear filtering */
+static int32_t
+draw_evaluate (lv_draw_unit_t *draw_unit, lv_draw_task_t *task)
+{
+  if (level == LVGL_GOVERNOR_FULL)
+    return 0;
+
+  switch (task->type)
+  {
+    case LV_DRAW_TASK_TYPE_BOX_SHADOW:
+      task->preference_score = 0;
+      task->preferred_draw_unit_id = DRAW_UNIT_ID;
+      break;
+
+    case LV_DRAW_TASK_TYPE_IMAGE:
+    case LV_DRAW_TASK_TYPE_LAYER:
+      ((lv_draw_image_dsc_t *)task->draw_dsc)->antialias = 0;
+      break;
+
+    default:
+      break;
+  }
+
+  return 0;
+}
+
+static int32_t
+draw_dispatch (lv_draw_unit_t *draw_unit, lv_layer_t *layer)
+{
+  lv_draw_task_t * task = lv_draw_get_next_available_task(layer, NULL, DRAW_UNIT_ID);
+
+  /* idle */
+  if (task == NULL)
+    return -1;
+
+  task->state = LV_DRAW_TASK_STATE_READY;
+  lv_draw_dispatch_request();
+  return 1;
+}
+
+static void
+uart_print (const char *s)
+{
+  HAL_UART_Transmit(&LVGL_GOVERNOR_UART, (const uint8_t *)s, lv_strlen(s), 100);
+}
+
+#else
+
+void
+lvgl_governor_init (void)
+{
+}
+
+lvgl_governor_level_t
+lvgl_governor_get_level (void)
+{
+  return LVGL_GOVERNOR_FULL;
+}
+
+#endif /* LVGL_GOVERNOR */
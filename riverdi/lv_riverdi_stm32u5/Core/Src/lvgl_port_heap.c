@@ -0,0 +1,581 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_heap.h"
+#include "lvgl_port_arena.h"
+#include "lvgl/lvgl.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* the TLSF core is adapted from the MP135 port's lv_port_mem.c, which
+ * documents the lists and block layout; it differs in the alignment, the
+ * size limit, the regions and the FreeRTOS locking */
+#define ALIGN_SIZE        portBYTE_ALIGNMENT
+#define SL_LOG2           4
+#define SL_COUNT          (1 << SL_LOG2)
+#define FL_SHIFT          (SL_LOG2 + 3)
+#define SMALL_SIZE        (1 << FL_SHIFT)
+#define FL_MAX_LOG2       24
+#define FL_COUNT          (FL_MAX_LOG2 - FL_SHIFT + 1)
+#define MAX_SIZE          ((1UL << FL_MAX_LOG2) - 1)
+
+/* 8 bytes: payloads keep the FreeRTOS alignment */
+#define HDR_SIZE          (sizeof(block_t) - 2 * sizeof(block_t *))
+#define MIN_SIZE          (2 * sizeof(block_t *))
+
+#define BLOCK_FREE        0x1U
+#define BLOCK_PREV_FREE   0x2U
+#define BLOCK_FLAGS       (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define BLOCK_SIZE(b)     ((b)->size & ~BLOCK_FLAGS)
+#define BLOCK_NEXT(b)     ((block_t *)((uint8_t *)(b) + HDR_SIZE + BLOCK_SIZE(b)))
+#define BLOCK_PTR(b)      ((void *)((uint8_t *)(b) + HDR_SIZE))
+#define PTR_BLOCK(p)      ((block_t *)((uint8_t *)(p) - HDR_SIZE))
+#define FLS(x)            (31 - __builtin_clz(x))
+#define FFS(x)            ((uint32_t)__builtin_ctz(x))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct block
+{
+  struct block * prev_phys;
+  uint32_t size;
+  struct block * next_free;
+  struct block * prev_free;
+} block_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void *
+heap_alloc (size_t size);
+
+static void
+heap_free (void *p);
+
+static void *
+heap_realloc (void *p, size_t size);
+
+static bool
+add_region (void *start, size_t size);
+
+static void
+mapping (uint32_t size, uint32_t *fl, uint32_t *sl);
+
+static block_t *
+find_free (uint32_t size);
+
+static void
+insert_free (block_t *b);
+
+static void
+remove_free (block_t *b);
+
+static void
+split (block_t *b, uint32_t size);
+
+static block_t *
+merge_next (block_t *b);
+
+static void
+walk_free (HeapStats_t *stats);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/* STM32U599NJHXQ_FLASH.ld */
+extern uint8_t _heap_ram_start[];
+extern uint8_t _heap_ram_end[];
+extern uint8_t _heap_sram2_start[];
+extern uint8_t _heap_sram2_end[];
+extern uint8_t _heap_sram4_start[];
+extern uint8_t _heap_sram4_end[];
+
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[FL_COUNT];
+static block_t * free_lists[FL_COUNT][SL_COUNT];
+
+static uint32_t region_count;
+static size_t total;
+static size_t used;
+static size_t peak;
+static size_t allocations;
+static size_t frees;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_heap_init (void)
+{
+  /* RAM between the C heap and the main stack, then SRAM2 and SRAM4 */
+  add_region(_heap_ram_start, _heap_ram_end - _heap_ram_start);
+  add_region(_heap_sram2_start, _heap_sram2_end - _heap_sram2_start);
+  add_region(_heap_sram4_start, _heap_sram4_end - _heap_sram4_start);
+}
+
+bool
+lvgl_heap_add_region (void *start, size_t size)
+{
+  bool ok;
+
+  vTaskSuspendAll();
+  ok = add_region(start, size);
+  xTaskResumeAll();
+
+  return ok;
+}
+
+/* any task, not from interrupts; bounded time, the bitmaps point to a
+ * free list whose blocks all fit */
+void *
+lvgl_heap_alloc (size_t size)
+{
+  void * p;
+
+  vTaskSuspendAll();
+  p = heap_alloc(size);
+  xTaskResumeAll();
+
+  return p;
+}
+
+void
+lvgl_heap_free (void *p)
+{
+  vTaskSuspendAll();
+  heap_free(p);
+  xTaskResumeAll();
+}
+
+void *
+lvgl_heap_realloc (void *p, size_t size)
+{
+  vTaskSuspendAll();
+  p = heap_realloc(p, size);
+  xTaskResumeAll();
+
+  return p;
+}
+
+/* FreeRTOS memory management, replaces heap_4.c */
+
+void *
+pvPortMalloc (size_t size)
+{
+  void * p = lvgl_heap_alloc(size);
+
+#if configUSE_MALLOC_FAILED_HOOK == 1
+  if (p == NULL)
+  {
+    extern void vApplicationMallocFailedHook (void);
+    vApplicationMallocFailedHook();
+  }
+#endif
+
+  return p;
+}
+
+void
+vPortFree (void *p)
+{
+  lvgl_heap_free(p);
+}
+
+size_t
+xPortGetFreeHeapSize (void)
+{
+  return total - used;
+}
+
+size_t
+xPortGetMinimumEverFreeHeapSize (void)
+{
+  return total - peak;
+}
+
+void
+vPortInitialiseBlocks (void)
+{
+}
+
+void
+vPortGetHeapStats (HeapStats_t *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+
+  vTaskSuspendAll();
+  walk_free(stats);
+  stats->xMinimumEverFreeBytesRemaining = total - peak;
+  stats->xNumberOfSuccessfulAllocations = allocations;
+  stats->xNumberOfSuccessfulFrees = frees;
+  xTaskResumeAll();
+}
+
+/* LVGL memory management, LV_USE_STDLIB_MALLOC == LV_STDLIB_CUSTOM */
+
+void
+lv_mem_init (void)
+{
+  /* lvgl_heap_init() ran before the scheduler */
+}
+
+void
+lv_mem_deinit (void)
+{
+}
+
+lv_mem_pool_t
+lv_mem_add_pool (void *mem, size_t bytes)
+{
+  return lvgl_heap_add_region(mem, bytes) ? mem : NULL;
+}
+
+void
+lv_mem_remove_pool (lv_mem_pool_t pool)
+{
+  /* regions stay for good */
+}
+
+/* a screen being built in an arena is served from it first, see
+ * lvgl_port_arena.c */
+void *
+lv_malloc_core (size_t size)
+{
+  void * p = lvgl_arena_alloc(size);
+
+  return p != NULL ? p : lvgl_heap_alloc(size);
+}
+
+void *
+lv_realloc_core (void *p, size_t new_size)
+{
+  if (lvgl_arena_realloc(&p, new_size))
+    return p;
+
+  return lvgl_heap_realloc(p, new_size);
+}
+
+void
+lv_free_core (void *p)
+{
+  if (!lvgl_arena_free(p))
+    lvgl_heap_free(p);
+}
+
+void
+lv_mem_monitor_core (lv_mem_monitor_t *mon)
+{
+  HeapStats_t stats;
+
+  vPortGetHeapStats(&stats);
+
+  mon->total_size = total;
+  mon->free_size = stats.xAvailableHeapSpaceInBytes;
+  mon->free_cnt = stats.xNumberOfFreeBlocks;
+  mon->free_biggest_size = stats.xSizeOfLargestFreeBlockInBytes;
+  mon->used_cnt = stats.xNumberOfSuccessfulAllocations - stats.xNumberOfSuccessfulFrees;
+  mon->max_used = peak;
+  mon->used_pct = total ? 100 - (uint64_t)mon->free_size * 100 / total : 0;
+  mon->frag_pct = mon->free_size ?
+                  100 - (uint64_t)mon->free_biggest_size * 100 / mon->free_size : 0;
+}
+
+lv_result_t
+lv_mem_test_core (void)
+{
+  return LV_RESULT_OK;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void *
+heap_alloc (size_t size)
+{
+  block_t * b;
+
+  if (size == 0 || size > MAX_SIZE)
+    return NULL;
+
+  size = LV_MAX((size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1), MIN_SIZE);
+
+  b = find_free(size);
+  if (b == NULL)
+    return NULL;
+
+  remove_free(b);
+  split(b, size);
+
+  b->size &= ~BLOCK_FREE;
+  BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+
+  used += HDR_SIZE + BLOCK_SIZE(b);
+  peak = LV_MAX(peak, used);
+  allocations++;
+  return BLOCK_PTR(b);
+}
+
+static void
+heap_free (void *p)
+{
+  block_t * b;
+
+  if (p == NULL)
+    return;
+
+  b = PTR_BLOCK(p);
+  used -= HDR_SIZE + BLOCK_SIZE(b);
+  frees++;
+
+  b->size |= BLOCK_FREE;
+
+  if (b->size & BLOCK_PREV_FREE)
+  {
+    block_t * prev = b->prev_phys;
+
+    remove_free(prev);
+    prev->size += HDR_SIZE + BLOCK_SIZE(b);
+    b = prev;
+  }
+  b = merge_next(b);
+
+  BLOCK_NEXT(b)->prev_phys = b;
+  BLOCK_NEXT(b)->size |= BLOCK_PREV_FREE;
+  insert_free(b);
+}
+
+static void *
+heap_realloc (void *p, size_t size)
+{
+  block_t * b;
+  block_t * next;
+  uint32_t cur;
+  void * np;
+
+  if (p == NULL)
+    return heap_alloc(size);
+
+  if (size == 0)
+  {
+    heap_free(p);
+    return NULL;
+  }
+
+  if (size > MAX_SIZE)
+    return NULL;
+
+  b = PTR_BLOCK(p);
+  cur = BLOCK_SIZE(b);
+  size = LV_MAX((size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1), MIN_SIZE);
+
+  if (size <= cur)
+    return p;
+
+  next = BLOCK_NEXT(b);
+  if ((next->size & BLOCK_FREE) && cur + HDR_SIZE + BLOCK_SIZE(next) >= size)
+  {
+    used -= HDR_SIZE + cur;
+    remove_free(next);
+    b->size += HDR_SIZE + BLOCK_SIZE(next);
+    BLOCK_NEXT(b)->prev_phys = b;
+    BLOCK_NEXT(b)->size &= ~BLOCK_PREV_FREE;
+    split(b, size);
+    used += HDR_SIZE + BLOCK_SIZE(b);
+    peak = LV_MAX(peak, used);
+    return p;
+  }
+
+  np = heap_alloc(size);
+  if (np == NULL)
+    return NULL;
+
+  memcpy(np, p, cur);
+  heap_free(p);
+  return np;
+}
+
+/* one free block over the region, then a zero-sized used block that stops
+ * merging at its end */
+static bool
+add_region (void *start, size_t size)
+{
+  uintptr_t first = ((uintptr_t)start + ALIGN_SIZE - 1) & ~(uintptr_t)(ALIGN_SIZE - 1);
+  uintptr_t end = ((uintptr_t)start + size) & ~(uintptr_t)(ALIGN_SIZE - 1);
+  block_t * b = (block_t *)first;
+  block_t * last;
+  size_t payload;
+
+  if (region_count == LVGL_HEAP_MAX_REGIONS || end < first + 2 * HDR_SIZE + MIN_SIZE)
+    return false;
+
+  payload = LV_MIN(end - first - 2 * HDR_SIZE, MAX_SIZE & ~(ALIGN_SIZE - 1));
+
+  b->prev_phys = NULL;
+  b->size = payload | BLOCK_FREE;
+
+  last = BLOCK_NEXT(b);
+  last->prev_phys = b;
+  last->size = BLOCK_PREV_FREE;
+
+  insert_free(b);
+  total += payload + 2 * HDR_SIZE;
+  region_count++;
+  return true;
+}
+
+static void
+mapping (uint32_t size, uint32_t *fl, uint32_t *sl)
+{
+  uint32_t f;
+
+  if (size < SMALL_SIZE)
+  {
+    *fl = 0;
+    *sl = size / (SMALL_SIZE / SL_COUNT);
+  }
+  else
+  {
+    f = FLS(size);
+    *sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+    *fl = f - FL_SHIFT + 1;
+  }
+}
+
+static block_t *
+find_free (uint32_t size)
+{
+  uint32_t fl, sl, map;
+
+  if (size >= SMALL_SIZE)
+    size += (1UL << (FLS(size) - SL_LOG2)) - 1;
+  mapping(size, &fl, &sl);
+
+  if (fl >= FL_COUNT)
+    return NULL;
+
+  map = sl_bitmap[fl] & (~0UL << sl);
+  if (map == 0)
+  {
+    map = (fl + 1 < FL_COUNT) ? fl_bitmap & (~0UL << (fl + 1)) : 0;
+    if (map == 0)
+      return NULL;
+    fl = FFS(map);
+    map = sl_bitmap[fl];
+  }
+  sl = FFS(map);
+
+  return free_lists[fl][sl];
+}
+
+static void
+insert_free (block_t *b)
+{
+  uint32_t fl, sl;
+
+  mapping(BLOCK_SIZE(b), &fl, &sl);
+
+  b->prev_free = NULL;
+  b->next_free = free_lists[fl][sl];
+  if (b->next_free)
+    b->next_free->prev_free = b;
+  free_lists[fl][sl] = b;
+
+  fl_bitmap |= 1UL << fl;
+  sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void
+remove_free (block_t *b)
+{
+  uint32_t fl, sl;
+
+  mapping(BLOCK_SIZE(b), &fl, &sl);
+
+  if (b->prev_free)
+    b->prev_free->next_free = b->next_free;
+  else
+    free_lists[fl][sl] = b->next_free;
+  if (b->next_free)
+    b->next_free->prev_free = b->prev_free;
+
+  if (free_lists[fl][sl] == NULL)
+  {
+    sl_bitmap[fl] &= ~(1UL << sl);
+    if (sl_bitmap[fl] == 0)
+      fl_bitmap &= ~(1UL << fl);
+  }
+}
+
+/* give the tail of a block that is on no free list back to the heap, if
+ * it is large enough for a block of its own */
+static void
+split (block_t *b, uint32_t size)
+{
+  block_t * rest;
+  uint32_t rest_size;
+
+  if (BLOCK_SIZE(b) < size + HDR_SIZE + MIN_SIZE)
+    return;
+
+  rest_size = BLOCK_SIZE(b) - size - HDR_SIZE;
+  b->size = size | (b->size & BLOCK_FLAGS);
+
+  rest = BLOCK_NEXT(b);
+  rest->prev_phys = b;
+  rest->size = rest_size | BLOCK_FREE | ((b->size & BLOCK_FREE) ? BLOCK_PREV_FREE : 0);
+  rest = merge_next(rest);
+
+  BLOCK_NEXT(rest)->prev_phys = rest;
+  BLOCK_NEXT(rest)->size |= BLOCK_PREV_FREE;
+  insert_free(rest);
+}
+
+static block_t *
+merge_next (block_t *b)
+{
+  block_t * next = BLOCK_NEXT(b);
+
+  if (next->size & BLOCK_FREE)
+  {
+    remove_free(next);
+    b->size += HDR_SIZE + BLOCK_SIZE(next);
+  }
+  return b;
+}
+
+static void
+walk_free (HeapStats_t *stats)
+{
+  uint32_t fl, sl;
+  block_t * b;
+
+  stats->xSizeOfSmallestFreeBlockInBytes = SIZE_MAX;
+
+  for (fl = 0; fl < FL_COUNT; fl++)
+    for (sl = 0; sl < SL_COUNT; sl++)
+      for (b = free_lists[fl][sl]; b != NULL; b = b->next_free)
+      {
+        stats->xAvailableHeapSpaceInBytes += BLOCK_SIZE(b);
+        stats->xNumberOfFreeBlocks++;
+        stats->xSizeOfLargestFreeBlockInBytes =
+          LV_MAX(stats->xSizeOfLargestFreeBlockInBytes, BLOCK_SIZE(b));
+        stats->xSizeOfSmallestFreeBlockInBytes =
+          LV_MIN(stats->xSizeOfSmallestFreeBlockInBytes, BLOCK_SIZE(b));
+      }
+
+  if (stats->xNumberOfFreeBlocks == 0)
+    stats->xSizeOfSmallestFreeBlockInBytes = 0;
+}
@@ -0,0 +1,211 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_image.h"
+#include "lvgl_port_cache.h"
+#include "lvgl_port_dma2d.h"
+#include "main.h"
+#include "dma2d.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  uint32_t format;
+  uint32_t clut_size;
+  const lv_color32_t * clut;
+  const uint8_t * pixels;
+  uint32_t pixel_offset;    /* padding pixels at the end of each line */
+  bool opaque;
+} clut_image_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static lv_result_t decoder_info (lv_image_decoder_t *, const void *, lv_image_header_t *);
+static lv_result_t decoder_open (lv_image_decoder_t *, lv_image_decoder_dsc_t *);
+static void decoder_close (lv_image_decoder_t *, lv_image_decoder_dsc_t *);
+static bool clut_image_parse (const void *, clut_image_t *);
+static lv_result_t dma2d_expand (const clut_image_t *, const lv_image_header_t *, lv_draw_buf_t *);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_image_init (void)
+{
+  /* created last, so it is asked before the built-in decoders */
+  lv_image_decoder_t * dec = lv_image_decoder_create();
+
+  lv_image_decoder_set_info_cb(dec, decoder_info);
+  lv_image_decoder_set_open_cb(dec, decoder_open);
+  lv_image_decoder_set_close_cb(dec, decoder_close);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_result_t
+decoder_info (lv_image_decoder_t * decoder,
+              const void * src,
+              lv_image_header_t * header)
+{
+  const lv_image_dsc_t * img = src;
+  clut_image_t clut;
+
+  LV_UNUSED(decoder);
+
+  if (!clut_image_parse(src, &clut))
+    return LV_RESULT_INVALID;
+
+  /* report what open() hands to the renderer, not the stored format */
+  *header = img->header;
+  header->cf = clut.opaque ? LV_COLOR_FORMAT_RGB565 : LV_COLOR_FORMAT_ARGB8888;
+  header->stride = header->w * lv_color_format_get_size(header->cf);
+  header->flags &= ~LVGL_IMAGE_FLAG_CLUT;
+
+  return LV_RESULT_OK;
+}
+
+static lv_result_t
+decoder_open (lv_image_decoder_t * decoder,
+              lv_image_decoder_dsc_t * dsc)
+{
+  clut_image_t clut;
+  lv_draw_buf_t * buf;
+
+  LV_UNUSED(decoder);
+
+  if (!clut_image_parse(dsc->src, &clut))
+    return LV_RESULT_INVALID;
+
+  buf = lv_draw_buf_create(dsc->header.w, dsc->header.h,
+                           dsc->header.cf, dsc->header.stride);
+  if (buf == NULL)
+  {
+    LV_LOG_WARN("no memory for a %dx%d CLUT image",
+                (int)dsc->header.w, (int)dsc->header.h);
+    return LV_RESULT_INVALID;
+  }
+
+  if (dma2d_expand(&clut, &dsc->header, buf) != LV_RESULT_OK)
+  {
+    lv_draw_buf_destroy(buf);
+    return LV_RESULT_INVALID;
+  }
+
+  dsc->decoded = buf;
+  return LV_RESULT_OK;
+}
+
+static void
+decoder_close (lv_image_decoder_t * decoder,
+               lv_image_decoder_dsc_t * dsc)
+{
+  LV_UNUSED(decoder);
+
+  lv_draw_buf_destroy((lv_draw_buf_t *)dsc->decoded);
+}
+
+static bool
+clut_image_parse (const void * src, clut_image_t * clut)
+{
+  const lv_image_dsc_t * img = src;
+  const lvgl_clut_header_t * hdr;
+  uint32_t i;
+
+  if (lv_image_src_get_type(src) != LV_IMAGE_SRC_VARIABLE)
+    return false;
+
+  if (img->header.cf == LV_COLOR_FORMAT_I8)
+  {
+    clut->format = LVGL_CLUT_L8;
+    clut->clut_size = 256;
+    clut->clut = (const lv_color32_t *)img->data;
+    clut->pixels = img->data + 256 * sizeof(lv_color32_t);
+    clut->pixel_offset = img->header.stride ? img->header.stride - img->header.w : 0;
+
+    clut->opaque = true;
+    for (i = 0; i < clut->clut_size; i++)
+      if (clut->clut[i].alpha != 0xFF)
+        clut->opaque = false;
+
+    return true;
+  }
+
+  if (img->header.cf != LV_COLOR_FORMAT_RAW_ALPHA ||
+      !(img->header.flags & LVGL_IMAGE_FLAG_CLUT))
+    return false;
+
+  hdr = (const lvgl_clut_header_t *)img->data;
+  if (hdr->clut_size == 0 || hdr->clut_size > 256)
+    return false;
+
+  clut->format = hdr->format;
+  clut->clut_size = hdr->clut_size;
+  clut->clut = (const lv_color32_t *)(hdr + 1);
+  clut->pixels = (const uint8_t *)(clut->clut + hdr->clut_size);
+  clut->opaque = hdr->opaque;
+
+  switch (hdr->format)
+  {
+    case LVGL_CLUT_L4:
+      /* 4-bit lines are padded to whole bytes */
+      clut->pixel_offset = img->header.w & 1U;
+      break;
+    case LVGL_CLUT_L8:
+    case LVGL_CLUT_AL44:
+    case LVGL_CLUT_AL88:
+      clut->pixel_offset = 0;
+      break;
+    default:
+      return false;
+  }
+
+  /* per-pixel alpha can never go to RGB565 */
+  if (hdr->format == LVGL_CLUT_AL44 || hdr->format == LVGL_CLUT_AL88)
+    clut->opaque = false;
+
+  return true;
+}
+
+static lv_result_t
+dma2d_expand (const clut_image_t * clut,
+              const lv_image_header_t * header,
+              lv_draw_buf_t * buf)
+{
+  uint32_t px_size = lv_color_format_get_size(header->cf);
+  lvgl_dma2d_job_t job = {
+    .cr = DMA2D_M2M_PFC,
+    .fgcmar = (uint32_t)clut->clut,
+    .fgpfccr = (clut->format << DMA2D_FGPFCCR_CM_Pos) |
+               ((clut->clut_size - 1) << DMA2D_FGPFCCR_CS_Pos),
+    .fgmar = (uint32_t)clut->pixels,
+    .fgor = clut->pixel_offset,
+    .opfccr = (header->cf == LV_COLOR_FORMAT_RGB565) ?
+              DMA2D_OUTPUT_RGB565 : DMA2D_OUTPUT_ARGB8888,
+    .omar = (uint32_t)buf->data,
+    .oor = buf->header.stride / px_size - header->w,
+    .nlr = (header->w << DMA2D_NLR_PL_Pos) | (header->h << DMA2D_NLR_NL_Pos),
+  };
+
+  lvgl_cache_to_master(LVGL_CACHE_MASTER_DMA2D, clut->clut,
+                       clut->clut_size * sizeof(lv_color32_t));
+
+  /* queued behind a running flush */
+  if (!lvgl_dma2d_run(&job))
+  {
+    LV_LOG_ERROR("DMA2D error while expanding a CLUT image");
+    return LV_RESULT_INVALID;
+  }
+
+  lvgl_cache_from_master(LVGL_CACHE_MASTER_DMA2D, buf->data, buf->data_size);
+
+  return LV_RESULT_OK;
+}
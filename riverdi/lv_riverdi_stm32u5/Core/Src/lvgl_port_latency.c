@@ -0,0 +1,210 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_latency.h"
+#include "lvgl_port_display.h"
+#include "main.h"
+#include "usart.h"
+
+#if LVGL_LATENCY_TRACE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* the bin line: a comma and up to 10 digits per bin */
+#define LINE_SIZE         (LVGL_LATENCY_BINS * 11 + 1)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  uint32_t bins[LVGL_LATENCY_BINS];
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+} histogram_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+record (histogram_t *h, uint32_t us);
+
+static void
+report_timer_cb (lv_timer_t *);
+
+static void
+uart_print (const char *s);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/* [0] touch to visible, [n] stage n-1 to stage n */
+static const char * const names[LVGL_LATENCY_STAGES] = {
+  "total", "touch>read", "read>render", "render>flush", "flush>visible"
+};
+
+static histogram_t hist[LVGL_LATENCY_STAGES];
+static uint32_t stamp[LVGL_LATENCY_STAGES];
+static volatile lvgl_latency_stage_t next;
+static uint32_t cycles_per_us;
+static uint32_t reported;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_latency_init (void)
+{
+  uint32_t i;
+
+  /* DWT cycle counter as the time base */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+  cycles_per_us = SystemCoreClock / 1000000;
+
+  for (i = 0; i < LVGL_LATENCY_STAGES; i++)
+    hist[i].min = UINT32_MAX;
+  next = LVGL_LATENCY_TOUCH;
+
+  lv_timer_create(report_timer_cb, LVGL_LATENCY_REPORT_MS, NULL);
+}
+
+void
+lvgl_latency_mark (lvgl_latency_stage_t stage)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now = DWT->CYCCNT;
+  uint32_t i;
+
+  __disable_irq();
+
+  /* a new trace starts on a touch when idle or when the last one stalled,
+   * e.g. the touch did not change any pixel */
+  if (stage == LVGL_LATENCY_TOUCH)
+  {
+    if (next == LVGL_LATENCY_TOUCH ||
+        now - stamp[LVGL_LATENCY_TOUCH] > LVGL_LATENCY_TIMEOUT_MS * 1000 * cycles_per_us)
+    {
+      stamp[LVGL_LATENCY_TOUCH] = now;
+      next = LVGL_LATENCY_READ;
+    }
+  }
+  else if (stage == next)
+  {
+    stamp[stage] = now;
+
+    if (stage == LVGL_LATENCY_FLUSH)
+    {
+      /* the frame is out once the LTDC leaves the active area; with a
+       * single buffer, rows above the beam show one scan later */
+      lvgl_display_vblank_request();
+    }
+
+    if (stage == LVGL_LATENCY_VISIBLE)
+    {
+      record(&hist[0], (now - stamp[LVGL_LATENCY_TOUCH]) / cycles_per_us);
+      for (i = 1; i < LVGL_LATENCY_STAGES; i++)
+        record(&hist[i], (stamp[i] - stamp[i - 1]) / cycles_per_us);
+      next = LVGL_LATENCY_TOUCH;
+    }
+    else
+      next = stage + 1;
+  }
+
+  __set_PRIMASK(primask);
+}
+
+void
+lvgl_latency_report (void)
+{
+  static char line[LINE_SIZE];
+  uint32_t i, b;
+  int n, r;
+
+  for (i = 0; i < LVGL_LATENCY_STAGES; i++)
+  {
+    histogram_t * h = &hist[i];
+
+    if (h->count == 0)
+      continue;
+
+    lv_snprintf(line, sizeof(line), "latency %s n=%lu min=%lu avg=%lu max=%lu us\r\n",
+                names[i], h->count, h->min, (uint32_t)(h->sum / h->count), h->max);
+    uart_print(line);
+
+    /* one count per ms bin */
+    for (b = 0, n = 0; b < LVGL_LATENCY_BINS; b++)
+    {
+      r = lv_snprintf(line + n, sizeof(line) - n, b ? ",%lu" : "%lu", h->bins[b]);
+      if (r < 0 || r >= (int)sizeof(line) - n)
+      {
+        /* drop the partial count */
+        line[n] = '\0';
+        break;
+      }
+      n += r;
+    }
+    uart_print(line);
+    uart_print("\r\n");
+  }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+record (histogram_t *h, uint32_t us)
+{
+  h->bins[LV_MIN(us / LVGL_LATENCY_BIN_US, LVGL_LATENCY_BINS - 1)]++;
+  h->count++;
+  h->sum += us;
+  h->min = LV_MIN(h->min, us);
+  h->max = LV_MAX(h->max, us);
+}
+
+static void
+report_timer_cb (lv_timer_t * timer)
+{
+  /* only when something new was traced */
+  if (hist[0].count == reported)
+    return;
+  reported = hist[0].count;
+
+  lvgl_latency_report();
+}
+
+static void
+uart_print (const char *s)
+{
+  HAL_UART_Transmit(&LVGL_LATENCY_UART, (const uint8_t *)s, lv_strlen(s), 100);
+}
+
+#else
+
+void
+lvgl_latency_init (void)
+{
+}
+
+void
+lvgl_latency_mark (lvgl_latency_stage_t stage)
+{
+}
+
+void
+lvgl_latency_report (void)
+{
+}
+
+#endif /* LVGL_LATENCY_TRACE */
@@ -0,0 +1,199 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_overlay.h"
+#include "lvgl_port_cache.h"
+#include "lvgl_port_dma2d.h"
+#include "lvgl_port_task.h"
+#include "main.h"
+#include "ltdc.h"
+#include "dma2d.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define OVERLAY_LAYER    1
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void ovl_flush_argb4444 (lv_display_t *, const lv_area_t *, uint8_t *);
+static void ovl_flush_al88 (lv_display_t *, const lv_area_t *, uint8_t *);
+static void ovl_flush_complete (void *, bool);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static lv_display_t * ovl;
+static int32_t ovl_w;
+static LV_ATTRIBUTE_LARGE_RAM_ARRAY __attribute__((aligned(32))) uint16_t layer_buf[LVGL_OVERLAY_MAX_W * LVGL_OVERLAY_MAX_H];
+static LV_ATTRIBUTE_DMA __attribute__((aligned(32))) uint8_t draw_buf[LVGL_OVERLAY_MAX_W * LVGL_OVERLAY_DRAW_LINES * 4];
+static uint32_t clut[256];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t *
+lvgl_overlay_create (int32_t x, int32_t y, int32_t w, int32_t h,
+                     lvgl_overlay_format_t format)
+{
+  LTDC_LayerCfgTypeDef layer = {0};
+  lv_obj_t * scr;
+
+  LV_ASSERT(w > 0 && w <= LVGL_OVERLAY_MAX_W);
+  LV_ASSERT(h > 0 && h <= LVGL_OVERLAY_MAX_H);
+
+  ovl_w = w;
+  lv_memzero(layer_buf, sizeof(layer_buf));
+
+  /* LVGL renders the overlay in ARGB8888, the flush packs it to 16 bits */
+  ovl = lv_display_create(w, h);
+  lv_display_set_color_format(ovl, LV_COLOR_FORMAT_ARGB8888);
+  lv_display_set_buffers(ovl, draw_buf, NULL, w * LVGL_OVERLAY_DRAW_LINES * 4,
+                         LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(ovl, format == LVGL_OVERLAY_AL88 ?
+                          ovl_flush_al88 : ovl_flush_argb4444);
+
+  scr = lv_display_get_screen_active(ovl);
+  lv_obj_set_style_bg_opa(scr, LV_OPA_TRANSP, 0);
+
+  /* straight alpha: out = a * overlay + (1 - a) * layer 0 */
+  layer.WindowX0 = x;
+  layer.WindowX1 = x + w;
+  layer.WindowY0 = y;
+  layer.WindowY1 = y + h;
+  layer.PixelFormat = format == LVGL_OVERLAY_AL88 ?
+                      LTDC_PIXEL_FORMAT_AL88 : LTDC_PIXEL_FORMAT_ARGB4444;
+  layer.Alpha = 255;
+  layer.Alpha0 = 0;
+  layer.BlendingFactor1 = LTDC_BLENDING_FACTOR1_PAxCA;
+  layer.BlendingFactor2 = LTDC_BLENDING_FACTOR2_PAxCA;
+  layer.FBStartAdress = (uint32_t)layer_buf;
+  layer.ImageWidth = w;
+  layer.ImageHeight = h;
+  if (HAL_LTDC_ConfigLayer(&hltdc, &layer, OVERLAY_LAYER) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  if (format == LVGL_OVERLAY_AL88)
+    lvgl_overlay_set_tint(lv_color_white());
+
+  __HAL_LTDC_LAYER_DISABLE(&hltdc, OVERLAY_LAYER);
+  __HAL_LTDC_RELOAD_IMMEDIATE_CONFIG(&hltdc);
+
+  /* nothing to render while hidden */
+  lv_timer_pause(lv_display_get_refr_timer(ovl));
+
+  return ovl;
+}
+
+void
+lvgl_overlay_show (bool show)
+{
+  if (ovl == NULL)
+    return;
+
+  if (show)
+  {
+    lv_timer_resume(lv_display_get_refr_timer(ovl));
+    lv_obj_invalidate(lv_display_get_screen_active(ovl));
+    __HAL_LTDC_LAYER_ENABLE(&hltdc, OVERLAY_LAYER);
+  }
+  else
+  {
+    __HAL_LTDC_LAYER_DISABLE(&hltdc, OVERLAY_LAYER);
+    lv_timer_pause(lv_display_get_refr_timer(ovl));
+  }
+
+  /* take effect between frames */
+  __HAL_LTDC_VERTICAL_BLANKING_RELOAD_CONFIG(&hltdc);
+}
+
+void
+lvgl_overlay_move (int32_t x, int32_t y)
+{
+  if (ovl == NULL)
+    return;
+
+  HAL_LTDC_SetWindowPosition_NoReload(&hltdc, x, y, OVERLAY_LAYER);
+  __HAL_LTDC_VERTICAL_BLANKING_RELOAD_CONFIG(&hltdc);
+}
+
+void
+lvgl_overlay_set_tint (lv_color_t color)
+{
+  uint32_t l;
+
+  /* luminance 0..255 maps to black..color */
+  for (l = 0; l < 256; l++)
+    clut[l] = ((color.red * l / 255) << 16) |
+              ((color.green * l / 255) << 8) |
+               (color.blue * l / 255);
+
+  HAL_LTDC_ConfigCLUT(&hltdc, clut, 256, OVERLAY_LAYER);
+  HAL_LTDC_EnableCLUT(&hltdc, OVERLAY_LAYER);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+ovl_flush_argb4444 (lv_display_t * display,
+                    const lv_area_t * area,
+                    uint8_t * px_map)
+{
+  lv_coord_t width = lv_area_get_width(area);
+  lv_coord_t height = lv_area_get_height(area);
+
+  lvgl_dma2d_job_t job = {
+    .cr = DMA2D_M2M_PFC,
+    .fgpfccr = DMA2D_INPUT_ARGB8888,
+    .fgmar = (uint32_t)px_map,
+    .opfccr = DMA2D_OUTPUT_ARGB4444,
+    .omar = (uint32_t)&layer_buf[area->y1 * ovl_w + area->x1],
+    .oor = ovl_w - width,
+    .nlr = (width << DMA2D_NLR_PL_Pos) | (height << DMA2D_NLR_NL_Pos),
+    .done = ovl_flush_complete,
+  };
+
+  lvgl_cache_to_master(LVGL_CACHE_MASTER_DMA2D, px_map, width * height * 4);
+
+  lvgl_dma2d_submit(&job);
+}
+
+/* DMA2D cannot write AL88, the CPU packs it; overlays are small */
+static void
+ovl_flush_al88 (lv_display_t * display,
+                const lv_area_t * area,
+                uint8_t * px_map)
+{
+  const lv_color32_t * src = (const lv_color32_t *)px_map;
+  uint16_t * dst;
+  int32_t x, y;
+
+  for (y = area->y1; y <= area->y2; y++)
+  {
+    dst = &layer_buf[y * ovl_w + area->x1];
+    for (x = area->x1; x <= area->x2; x++, src++)
+      *dst++ = (src->alpha << 8) |
+               ((src->red * 77 + src->green * 150 + src->blue * 29) >> 8);
+  }
+
+  lvgl_cache_to_master(LVGL_CACHE_MASTER_LTDC, &layer_buf[area->y1 * ovl_w],
+                       lv_area_get_height(area) * ovl_w * 2);
+  lv_display_flush_ready(display);
+}
+
+static void
+ovl_flush_complete (void * user_data, bool ok)
+{
+  lv_display_flush_ready(ovl);
+  lvgl_task_wake();
+}
@@ -0,0 +1,115 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_present.h"
+#include "lvgl_port_display.h"
+#include "lvgl_port_tick.h"
+#include "main.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* period average weight 1/8 */
+#define PERIOD_AVG        8
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/* written by the LTDC and DMA2D interrupts */
+static volatile uint32_t vblank_us;
+static volatile uint32_t period_us;
+static volatile uint32_t depth = 1;
+static volatile bool sampled;
+
+static uint32_t sample_us;
+static uint32_t last_ms;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_present_init (void)
+{
+  lv_timer_set_period(lv_anim_get_timer(), LVGL_VSYNC_FALLBACK_MS);
+}
+
+/* the line event is only armed while something is drawn, so count the
+ * frames missed in between */
+void
+lvgl_present_vblank (void)
+{
+  uint32_t now = lvgl_tick_get_us();
+  uint32_t elapsed = now - vblank_us;
+  uint32_t period = period_us;
+  uint32_t frames;
+
+  vblank_us = now;
+
+  if (elapsed >= LVGL_PRESENT_MAX_PERIOD_US)
+    return;
+
+  if (period == 0)
+  {
+    period_us = elapsed;
+    return;
+  }
+
+  frames = (elapsed + period / 2) / period;
+  if (frames)
+    period_us = period + ((int32_t)(elapsed / frames) - (int32_t)period) / PERIOD_AVG;
+}
+
+/* the frame is whole in the frame buffer from the next scanout on: the
+ * blankings it took to get there are the depth of the next prediction */
+void
+lvgl_present_flushed (void)
+{
+  uint32_t period = period_us;
+
+  if (!sampled || period == 0)
+    return;
+  sampled = false;
+
+  depth = LV_MIN((lvgl_tick_get_us() - sample_us) / period + 1, LVGL_PRESENT_MAX_DEPTH);
+}
+
+void
+lvgl_present_anim_refresh (void)
+{
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now_us, present_us, ms;
+
+  __disable_irq();
+  sample_us = vblank_us;
+  present_us = sample_us + depth * period_us;
+  now_us = lvgl_tick_get_us();
+  ms = lvgl_tick_get_ms();
+  __set_PRIMASK(primask);
+
+  if ((int32_t)(present_us - now_us) > 0)
+    ms += (present_us - now_us) / 1000;
+
+  /* the animation time must never go back */
+  if ((int32_t)(ms - last_ms) < 0)
+    ms = last_ms;
+  last_ms = ms;
+
+  lvgl_tick_freeze(ms);
+  lv_anim_refr_now();
+  lvgl_tick_thaw();
+
+  /* the real time is behind the presentation time: keep the animation
+   * timer from running with it until the fallback period */
+  lv_timer_reset(lv_anim_get_timer());
+  sampled = true;
+}
+
+uint32_t
+lvgl_present_get_period_us (void)
+{
+  return period_us;
+}
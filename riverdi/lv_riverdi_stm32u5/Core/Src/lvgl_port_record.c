@@ -0,0 +1,269 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_record.h"
+
+#if LVGL_RECORD
+
+#ifndef LVGL_RECORD_HOST
+#include "main.h"
+#include "usart.h"
+#else
+#include <stdio.h>
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+print (const char *s);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static LV_ATTRIBUTE_LARGE_RAM_ARRAY lvgl_record_event_t record_buf[LVGL_RECORD_MAX_EVENTS];
+static uint32_t record_count;
+static uint32_t record_start;
+static bool recording;
+static bool last_released;
+
+static const lvgl_record_event_t * replay_events;
+static uint32_t replay_count;
+static uint32_t replay_pos;
+static uint32_t replay_start;
+static lvgl_replay_done_cb_t replay_done;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_record_start (void)
+{
+  record_count = 0;
+  record_start = lv_tick_get();
+  last_released = true;
+  recording = true;
+}
+
+uint32_t
+lvgl_record_stop (void)
+{
+  recording = false;
+  return record_count;
+}
+
+const lvgl_record_event_t *
+lvgl_record_get (uint32_t *count)
+{
+  *count = record_count;
+  return record_buf;
+}
+
+void
+lvgl_record_dump (void)
+{
+  char line[48];
+  uint32_t i;
+
+  print("static const lvgl_record_event_t recording[] = {\r\n");
+  for (i = 0; i < record_count; i++)
+  {
+    lv_snprintf(line, sizeof(line), "  { %lu, %d, %d },\r\n",
+                record_buf[i].time, record_buf[i].x, record_buf[i].y);
+    print(line);
+  }
+  print("};\r\n");
+}
+
+void
+lvgl_replay_start (const lvgl_record_event_t *events, uint32_t count,
+                   lvgl_replay_done_cb_t done_cb)
+{
+  recording = false;
+  replay_events = events;
+  replay_count = count;
+  replay_pos = 0;
+  replay_done = done_cb;
+  replay_start = lv_tick_get();
+}
+
+void
+lvgl_replay_stop (void)
+{
+  replay_events = NULL;
+}
+
+bool
+lvgl_replay_pending (void)
+{
+  return replay_events != NULL &&
+         (replay_pos == replay_count ||
+          lv_tick_elaps(replay_start) >= replay_events[replay_pos].time);
+}
+
+uint32_t
+lvgl_replay_wait (void)
+{
+  uint32_t elapsed;
+
+  if (replay_events == NULL)
+    return LV_NO_TIMER_READY;
+  if (replay_pos == replay_count)
+    return 0;
+
+  elapsed = lv_tick_elaps(replay_start);
+  return elapsed >= replay_events[replay_pos].time ?
+         0 : replay_events[replay_pos].time - elapsed;
+}
+
+/* returns false when not replaying: read the panel instead */
+bool
+lvgl_replay_read (lv_indev_data_t *data)
+{
+  static lv_point_t last;
+  const lvgl_record_event_t * ev;
+
+  if (replay_events == NULL)
+    return false;
+
+  /* end of the recording: release and hand the panel back */
+  if (replay_pos == replay_count)
+  {
+    lvgl_replay_done_cb_t done = replay_done;
+
+    data->point = last;
+    data->state = LV_INDEV_STATE_RELEASED;
+    replay_events = NULL;
+    if (done)
+      done();
+    return true;
+  }
+
+  /* nothing due yet: hold the last state */
+  if (lv_tick_elaps(replay_start) < replay_events[replay_pos].time)
+  {
+    data->point = last;
+    data->state = replay_pos && replay_events[replay_pos - 1].x != LVGL_RECORD_RELEASED ?
+                  LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    return true;
+  }
+
+  ev = &replay_events[replay_pos++];
+  if (ev->x == LVGL_RECORD_RELEASED)
+    data->state = LV_INDEV_STATE_RELEASED;
+  else
+  {
+    last.x = ev->x;
+    last.y = ev->y;
+    data->state = LV_INDEV_STATE_PRESSED;
+  }
+  data->point = last;
+
+  /* catch up on events that fell due within the same LVGL cycle */
+  data->continue_reading = replay_pos < replay_count &&
+                           lv_tick_elaps(replay_start) >= replay_events[replay_pos].time;
+  return true;
+}
+
+void
+lvgl_record_read (const lv_indev_data_t *data)
+{
+  bool released = data->state == LV_INDEV_STATE_RELEASED;
+  lvgl_record_event_t * ev;
+
+  if (!recording || (released && last_released))
+    return;
+  last_released = released;
+
+  if (record_count == LVGL_RECORD_MAX_EVENTS)
+  {
+    recording = false;
+    return;
+  }
+
+  ev = &record_buf[record_count++];
+  ev->time = lv_tick_elaps(record_start);
+  ev->x = released ? LVGL_RECORD_RELEASED : data->point.x;
+  ev->y = released ? LVGL_RECORD_RELEASED : data->point.y;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+print (const char *s)
+{
+#ifndef LVGL_RECORD_HOST
+  HAL_UART_Transmit(&huart1, (const uint8_t *)s, lv_strlen(s), 100);
+#else
+  fputs(s, stdout);
+#endif
+}
+
+#else
+
+void
+lvgl_record_start (void)
+{
+}
+
+uint32_t
+lvgl_record_stop (void)
+{
+  return 0;
+}
+
+const lvgl_record_event_t *
+lvgl_record_get (uint32_t *count)
+{
+  *count = 0;
+  return NULL;
+}
+
+void
+lvgl_record_dump (void)
+{
+}
+
+void
+lvgl_replay_start (const lvgl_record_event_t *events, uint32_t count,
+                   lvgl_replay_done_cb_t done_cb)
+{
+  if (done_cb)
+    done_cb();
+}
+
+void
+lvgl_replay_stop (void)
+{
+}
+
+bool
+lvgl_replay_pending (void)
+{
+  return false;
+}
+
+uint32_t
+lvgl_replay_wait (void)
+{
+  return LV_NO_TIMER_READY;
+}
+
+bool
+lvgl_replay_read (lv_indev_data_t *data)
+{
+  return false;
+}
+
+void
+lvgl_record_read (const lv_indev_data_t *data)
+{
+}
+
+#endif /* LVGL_RECORD */
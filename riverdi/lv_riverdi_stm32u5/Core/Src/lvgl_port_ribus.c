@@ -0,0 +1,380 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_ribus.h"
+#include "lvgl_port_display.h"
+#include "lvgl_port_task.h"
+#include "main.h"
+#include "spi.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* EVE (FT81x/BT81x) host commands */
+#define EVE_ACTIVE          0x00
+#define EVE_CLKEXT          0x44
+
+/* EVE memory map and registers */
+#define EVE_RAM_G           0x000000UL
+#define EVE_RAM_DL          0x300000UL
+#define REG_ID              0x302000UL
+#define REG_CPURESET        0x302020UL
+#define REG_HCYCLE          0x30202CUL
+#define REG_HOFFSET         0x302030UL
+#define REG_HSIZE           0x302034UL
+#define REG_HSYNC0          0x302038UL
+#define REG_HSYNC1          0x30203CUL
+#define REG_VCYCLE          0x302040UL
+#define REG_VOFFSET         0x302044UL
+#define REG_VSIZE           0x302048UL
+#define REG_VSYNC0          0x30204CUL
+#define REG_VSYNC1          0x302050UL
+#define REG_DLSWAP          0x302054UL
+#define REG_SWIZZLE         0x302064UL
+#define REG_CSPREAD         0x302068UL
+#define REG_PCLK_POL        0x30206CUL
+#define REG_PCLK            0x302070UL
+#define REG_GPIOX_DIR       0x302098UL
+#define REG_GPIOX           0x30209CUL
+#define REG_PWM_DUTY        0x3020D4UL
+
+#define EVE_ID              0x7C
+#define DLSWAP_FRAME        2
+#define EVE_RGB565          7
+
+/* display list commands */
+#define CLEAR(c, s, t)              ((0x26UL << 24) | ((c) << 2) | ((s) << 1) | (t))
+#define BITMAP_SOURCE(addr)         ((0x01UL << 24) | ((addr) & 0x3FFFFF))
+#define BITMAP_LAYOUT(f, stride, h) ((0x07UL << 24) | ((f) << 19) | (((stride) & 0x3FF) << 9) | ((h) & 0x1FF))
+#define BITMAP_LAYOUT_H(stride, h)  ((0x28UL << 24) | ((((stride) >> 10) & 0x3) << 2) | (((h) >> 9) & 0x3))
+#define BITMAP_SIZE(w, h)           ((0x08UL << 24) | (((w) & 0x1FF) << 9) | ((h) & 0x1FF))
+#define BITMAP_SIZE_H(w, h)         ((0x29UL << 24) | ((((w) >> 9) & 0x3) << 2) | (((h) >> 9) & 0x3))
+#define BEGIN_BITMAPS               ((0x1FUL << 24) | 1)
+#define VERTEX2F(x, y)              ((0x1UL << 30) | (((x) & 0x7FFF) << 15) | ((y) & 0x7FFF))
+#define END                         (0x21UL << 24)
+#define DISPLAY                     0UL
+
+#define RIBUS_FB            EVE_RAM_G
+#define RIBUS_STRIDE        (RIBUS_HOR_RES * 2)
+
+/* HAL transfer sizes are 16 bits */
+#define SPI_MAX_CHUNK       0xFFFFU
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  const uint8_t * src;
+  uint32_t addr;
+  uint32_t chunk_bytes;
+  uint32_t chunks_left;
+  uint32_t addr_step;
+  bool data_phase;      /* the address header went out, pixels follow */
+} ribus_xfer_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void ribus_flush (lv_display_t *, const lv_area_t *, uint8_t *);
+static void ribus_chunk_start (void);
+static bool ribus_dma_init (void);
+static void eve_host_cmd (uint8_t, uint8_t);
+static void eve_wr32 (uint32_t, uint32_t);
+static uint32_t eve_rd32 (uint32_t);
+static void eve_addr (uint32_t, bool);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static lv_display_t * ribus_disp;
+static volatile ribus_xfer_t xfer;
+static uint8_t xfer_hdr[3];
+static DMA_HandleTypeDef hdma_ribus_tx;
+static __attribute__((aligned(32))) uint8_t buf[RIBUS_HOR_RES * RIBUS_BUF_LINES * 2];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t *
+lvgl_ribus_display_init (void)
+{
+  static const uint32_t dl[] = {
+    CLEAR(1, 1, 1),
+    BITMAP_SOURCE(RIBUS_FB),
+    BITMAP_LAYOUT(EVE_RGB565, RIBUS_STRIDE, RIBUS_VER_RES),
+    BITMAP_LAYOUT_H(RIBUS_STRIDE, RIBUS_VER_RES),
+    BITMAP_SIZE(RIBUS_HOR_RES, RIBUS_VER_RES),
+    BITMAP_SIZE_H(RIBUS_HOR_RES, RIBUS_VER_RES),
+    BEGIN_BITMAPS,
+    VERTEX2F(0, 0),
+    END,
+    DISPLAY,
+  };
+  GPIO_InitTypeDef miso = {
+    .Pin = GPIO_PIN_3,
+    .Mode = GPIO_MODE_AF_PP,
+    .Pull = GPIO_PULLUP,
+    .Speed = GPIO_SPEED_FREQ_VERY_HIGH,
+    .Alternate = GPIO_AF5_SPI1,
+  };
+  uint32_t id;
+  uint32_t i;
+
+  /* EVE wants 8-bit frames and at most 11 MHz until its clock is up */
+  hspi1.Init.DataSize = SPI_DATASIZE_8BIT;
+  hspi1.Init.NSSPMode = SPI_NSS_PULSE_DISABLE;
+  hspi1.Init.FifoThreshold = SPI_FIFO_THRESHOLD_08DATA;
+  hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_16;
+  if (HAL_SPI_Init(&hspi1) != HAL_OK)
+    return NULL;
+
+  /* with a pull-up on MISO (PG3) an empty connector reads all ones, while
+   * an EVE drives the line from the first read on, even while booting */
+  HAL_GPIO_Init(GPIOG, &miso);
+
+  /* power cycle through PD_N */
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+  HAL_GPIO_WritePin(R_RST_GPIO_Port, R_RST_Pin, GPIO_PIN_RESET);
+  HAL_Delay(20);
+  HAL_GPIO_WritePin(R_RST_GPIO_Port, R_RST_Pin, GPIO_PIN_SET);
+  HAL_Delay(20);
+
+  eve_host_cmd(EVE_CLKEXT, 0);
+  eve_host_cmd(EVE_ACTIVE, 0);
+
+  for (i = 0; ((id = eve_rd32(REG_ID)) & 0xFF) != EVE_ID; i += 10)
+  {
+    if (id == 0xFFFFFFFFUL || i >= RIBUS_BOOT_TIMEOUT)
+      return NULL;
+    HAL_Delay(10);
+  }
+
+  for (i = 0; eve_rd32(REG_CPURESET) & 0x7; i++)
+  {
+    if (i == RIBUS_RESET_TIMEOUT)
+      return NULL;
+    HAL_Delay(1);
+  }
+
+  /* engine clock is running, speed up to 20 MHz */
+  hspi1.Init.BaudRatePrescaler = SPI_BAUDRATEPRESCALER_8;
+  HAL_SPI_Init(&hspi1);
+
+  eve_wr32(REG_HSIZE, RIBUS_HOR_RES);
+  eve_wr32(REG_HCYCLE, RIBUS_HCYCLE);
+  eve_wr32(REG_HOFFSET, RIBUS_HOFFSET);
+  eve_wr32(REG_HSYNC0, RIBUS_HSYNC0);
+  eve_wr32(REG_HSYNC1, RIBUS_HSYNC1);
+  eve_wr32(REG_VSIZE, RIBUS_VER_RES);
+  eve_wr32(REG_VCYCLE, RIBUS_VCYCLE);
+  eve_wr32(REG_VOFFSET, RIBUS_VOFFSET);
+  eve_wr32(REG_VSYNC0, RIBUS_VSYNC0);
+  eve_wr32(REG_VSYNC1, RIBUS_VSYNC1);
+  eve_wr32(REG_SWIZZLE, RIBUS_SWIZZLE);
+  eve_wr32(REG_PCLK_POL, RIBUS_PCLK_POL);
+  eve_wr32(REG_CSPREAD, RIBUS_CSPREAD);
+
+  /* the display list just shows RAM_G as an RGB565 bitmap */
+  for (i = 0; i < sizeof(dl) / sizeof(dl[0]); i++)
+    eve_wr32(EVE_RAM_DL + 4 * i, dl[i]);
+  eve_wr32(REG_DLSWAP, DLSWAP_FRAME);
+
+  /* DISP on, backlight on, start scanning */
+  eve_wr32(REG_GPIOX_DIR, eve_rd32(REG_GPIOX_DIR) | 0x8000);
+  eve_wr32(REG_GPIOX, eve_rd32(REG_GPIOX) | 0x8000);
+  eve_wr32(REG_PWM_DUTY, 128);
+  eve_wr32(REG_PCLK, RIBUS_PCLK);
+
+  if (!ribus_dma_init())
+    return NULL;
+
+  HAL_NVIC_SetPriority(SPI1_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(SPI1_IRQn);
+
+  /* shares the image/glyph caches with the primary, but has a draw buffer
+   * and a refresh timer of its own */
+  ribus_disp = lv_display_create(RIBUS_HOR_RES, RIBUS_VER_RES);
+  lv_display_set_buffers(ribus_disp, buf, NULL, sizeof(buf), LV_DISPLAY_RENDER_MODE_PARTIAL);
+  lv_display_set_flush_cb(ribus_disp, ribus_flush);
+  lv_timer_set_period(lv_display_get_refr_timer(ribus_disp), RIBUS_REFR_PERIOD);
+
+  return ribus_disp;
+}
+
+void
+HAL_SPI_TxCpltCallback (SPI_HandleTypeDef *hspi)
+{
+  if (hspi != &hspi1)
+    return;
+
+  /* the address header is out, send the pixels with CS still low */
+  if (!xfer.data_phase)
+  {
+    xfer.data_phase = true;
+    HAL_SPI_Transmit_DMA(&hspi1, (uint8_t *)xfer.src, xfer.chunk_bytes);
+    return;
+  }
+
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+
+  if (--xfer.chunks_left)
+  {
+    xfer.src += xfer.chunk_bytes;
+    xfer.addr += xfer.addr_step;
+    ribus_chunk_start();
+    return;
+  }
+
+  lv_display_flush_ready(ribus_disp);
+  lvgl_task_wake();
+}
+
+void
+HAL_SPI_ErrorCallback (SPI_HandleTypeDef *hspi)
+{
+  if (hspi != &hspi1)
+    return;
+
+  /* drop the rest of the area rather than leaving LVGL waiting */
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+  lv_display_flush_ready(ribus_disp);
+  lvgl_task_wake();
+}
+
+void
+lvgl_ribus_dma_irq (void)
+{
+  HAL_DMA_IRQHandler(&hdma_ribus_tx);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+ribus_flush (lv_display_t * display,
+             const lv_area_t * area,
+             uint8_t * px_map)
+{
+  uint32_t width = lv_area_get_width(area);
+  uint32_t height = lv_area_get_height(area);
+  uint32_t rows = 1;
+
+  /* full-width areas are contiguous in RAM_G, send several lines per burst */
+  if (width == RIBUS_HOR_RES)
+  {
+    rows = SPI_MAX_CHUNK / RIBUS_STRIDE;
+    while (height % rows)
+      rows--;
+  }
+
+  xfer.src = px_map;
+  xfer.addr = RIBUS_FB + (area->y1 * RIBUS_HOR_RES + area->x1) * 2;
+  xfer.chunk_bytes = width * 2 * rows;
+  xfer.chunks_left = height / rows;
+  xfer.addr_step = RIBUS_STRIDE * rows;
+
+  ribus_chunk_start();
+}
+
+/* runs in thread and SPI interrupt context: the address header and the
+ * pixels go out as two DMA transfers, chained by HAL_SPI_TxCpltCallback() */
+static void
+ribus_chunk_start (void)
+{
+  xfer_hdr[0] = ((xfer.addr >> 16) & 0x3F) | 0x80;
+  xfer_hdr[1] = xfer.addr >> 8;
+  xfer_hdr[2] = xfer.addr;
+  xfer.data_phase = false;
+
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_RESET);
+  HAL_SPI_Transmit_DMA(&hspi1, xfer_hdr, sizeof(xfer_hdr));
+}
+
+/* GPDMA channel for SPI1 transmit, byte wide, one request per byte */
+static bool
+ribus_dma_init (void)
+{
+  __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+  hdma_ribus_tx.Instance = RIBUS_DMA_CHANNEL;
+  hdma_ribus_tx.Init.Request = GPDMA1_REQUEST_SPI1_TX;
+  hdma_ribus_tx.Init.BlkHWRequest = DMA_BREQ_SINGLE_BURST;
+  hdma_ribus_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_ribus_tx.Init.SrcInc = DMA_SINC_INCREMENTED;
+  hdma_ribus_tx.Init.DestInc = DMA_DINC_FIXED;
+  hdma_ribus_tx.Init.SrcDataWidth = DMA_SRC_DATAWIDTH_BYTE;
+  hdma_ribus_tx.Init.DestDataWidth = DMA_DEST_DATAWIDTH_BYTE;
+  hdma_ribus_tx.Init.Priority = DMA_LOW_PRIORITY_HIGH_WEIGHT;
+  hdma_ribus_tx.Init.SrcBurstLength = 1;
+  hdma_ribus_tx.Init.DestBurstLength = 1;
+  hdma_ribus_tx.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT1;
+  hdma_ribus_tx.Init.TransferEventMode = DMA_TCEM_BLOCK_TRANSFER;
+  hdma_ribus_tx.Init.Mode = DMA_NORMAL;
+  if (HAL_DMA_Init(&hdma_ribus_tx) != HAL_OK)
+    return false;
+  if (HAL_DMA_ConfigChannelAttributes(&hdma_ribus_tx, DMA_CHANNEL_NPRIV) != HAL_OK)
+    return false;
+
+  __HAL_LINKDMA(&hspi1, hdmatx, hdma_ribus_tx);
+
+  HAL_NVIC_SetPriority(RIBUS_DMA_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(RIBUS_DMA_IRQn);
+
+  return true;
+}
+
+static void
+eve_host_cmd (uint8_t cmd, uint8_t param)
+{
+  uint8_t tx[3] = { cmd, param, 0 };
+
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_RESET);
+  HAL_SPI_Transmit(&hspi1, tx, sizeof(tx), 10);
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+}
+
+/* selects the chip and sends a memory address, leaves CS low */
+static void
+eve_addr (uint32_t addr, bool write)
+{
+  uint8_t tx[3] = {
+    ((addr >> 16) & 0x3F) | (write ? 0x80 : 0x00),
+    addr >> 8,
+    addr
+  };
+
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_RESET);
+  HAL_SPI_Transmit(&hspi1, tx, sizeof(tx), 10);
+}
+
+static void
+eve_wr32 (uint32_t addr, uint32_t value)
+{
+  uint8_t tx[4] = { value, value >> 8, value >> 16, value >> 24 };
+
+  eve_addr(addr, true);
+  HAL_SPI_Transmit(&hspi1, tx, sizeof(tx), 10);
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+}
+
+static uint32_t
+eve_rd32 (uint32_t addr)
+{
+  uint8_t dummy = 0;
+  uint8_t rx[4] = {0};
+
+  eve_addr(addr, false);
+  HAL_SPI_Transmit(&hspi1, &dummy, 1, 10);
+  HAL_SPI_Receive(&hspi1, rx, sizeof(rx), 10);
+  HAL_GPIO_WritePin(R_CS_GPIO_Port, R_CS_Pin, GPIO_PIN_SET);
+
+  return rx[0] | (rx[1] << 8) | (rx[2] << 16) | ((uint32_t)rx[3] << 24);
+}
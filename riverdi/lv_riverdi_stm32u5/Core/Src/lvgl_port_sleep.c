@@ -0,0 +1,193 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_sleep.h"
+#include "lvgl_port_tick.h"
+#include "main.h"
+#include "lptim.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/* LPTIM counts per tick are fractional (32.768), keep the sums scaled */
+#define COUNTS_TO_TICKS(c)    ((c) * configTICK_RATE_HZ / LVGL_SLEEP_LPTIM_HZ)
+#define TICKS_TO_COUNTS(t)    ((t) * LVGL_SLEEP_LPTIM_HZ / configTICK_RATE_HZ)
+
+/* the last tick of a sleep is counted by SysTick again */
+#define MAX_SLEEP_TICKS       (COUNTS_TO_TICKS(LVGL_SLEEP_MAX_COUNTS) - 1)
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+lptim_start (uint32_t counts);
+
+static uint32_t
+lptim_stop (uint32_t counts);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static volatile bool stop_allowed;
+
+/* time slept or spent in the current tick that is not yet stepped, in
+ * LPTIM counts: keeps the RTOS tick from drifting over many sleeps */
+static uint32_t residual;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_sleep_init (void)
+{
+  RCC_PeriphCLKInitTypeDef clk = {0};
+
+  /* CubeMX counts pulses on LPTIM2_IN1; count the internal clock instead */
+  hlptim2.Init.CounterSource = LPTIM_COUNTERSOURCE_INTERNAL;
+  hlptim2.Init.Period = LVGL_SLEEP_MAX_COUNTS;
+  if (HAL_LPTIM_Init(&hlptim2) != HAL_OK)
+    Error_Handler();
+
+  /* from LSE, which keeps running in Stop */
+  clk.PeriphClockSelection = RCC_PERIPHCLK_LPTIM2;
+  clk.Lptim2ClockSelection = RCC_LPTIM2CLKSOURCE_LSE;
+  if (HAL_RCCEx_PeriphCLKConfig(&clk) != HAL_OK)
+    Error_Handler();
+
+  /* DIER is only writable while enabled */
+  __HAL_LPTIM_ENABLE(&LVGL_SLEEP_LPTIM);
+  __HAL_LPTIM_CLEAR_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_DIEROK);
+  __HAL_LPTIM_ENABLE_IT(&LVGL_SLEEP_LPTIM, LPTIM_IT_ARRM);
+  while (!__HAL_LPTIM_GET_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_DIEROK));
+  LVGL_SLEEP_LPTIM.Instance->CR &= ~LPTIM_CR_ENABLE;
+
+  HAL_NVIC_SetPriority(LPTIM2_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(LPTIM2_IRQn);
+}
+
+void
+lvgl_sleep_allow_stop (bool allow)
+{
+  stop_allowed = allow;
+}
+
+void
+lvgl_sleep_lptim_irq (void)
+{
+  __HAL_LPTIM_CLEAR_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_ARRM);
+}
+
+/* configUSE_TICKLESS_IDLE 2: called by the idle task with the scheduler
+ * suspended when no task is due for expected ticks */
+void
+vPortSuppressTicksAndSleep (TickType_t expected)
+{
+  uint32_t counts, elapsed, ticks;
+  bool stop;
+
+  expected = LV_MIN(expected, MAX_SLEEP_TICKS + 1);
+
+  SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+  /* a pending interrupt still ends WFI while masked */
+  __disable_irq();
+  __DSB();
+  __ISB();
+
+  /* a task became ready since the idle task decided to sleep */
+  if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+  {
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    __enable_irq();
+    return;
+  }
+
+  /* the part of the current tick already gone counts towards this sleep */
+  residual += (SysTick->LOAD - SysTick->VAL) / (SystemCoreClock / LVGL_SLEEP_LPTIM_HZ);
+
+  counts = TICKS_TO_COUNTS(expected - 1);
+  counts = counts > residual ? counts - residual : 1;
+  lptim_start(counts);
+
+  /* the TIM2 HAL timebase would end the sleep every ms */
+  HAL_SuspendTick();
+
+  stop = stop_allowed;
+  if (stop)
+    HAL_PWREx_EnterSTOP1Mode(PWR_STOPENTRY_WFI);
+  else
+  {
+    __DSB();
+    __WFI();
+    __ISB();
+  }
+
+  elapsed = lptim_stop(counts);
+
+  /* the HAL tick runs at 1 kHz like the RTOS tick */
+  uwTick += COUNTS_TO_TICKS(elapsed);
+  HAL_ResumeTick();
+
+  /* Stop halts TIM5 */
+  if (stop)
+    lvgl_tick_add_us(elapsed * 1000000ULL / LVGL_SLEEP_LPTIM_HZ);
+
+  residual += elapsed;
+  ticks = LV_MIN(COUNTS_TO_TICKS(residual), expected - 1);
+  residual -= TICKS_TO_COUNTS(ticks);
+
+  SysTick->VAL = 0;
+  SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+  vTaskStepTick(ticks);
+
+  __enable_irq();
+
+  /* Stop falls back to MSI; the oscillator and PLL waits time out on
+   * HAL_GetTick(), so the clocks come back with interrupts enabled.
+   * Interrupts taken before that run from MSI, the scheduler stays
+   * suspended until the idle task returns */
+  if (stop)
+    SystemClock_Config();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* one-shot up to counts, the ARR write takes a few LSE cycles to land */
+static void
+lptim_start (uint32_t counts)
+{
+  __HAL_LPTIM_ENABLE(&LVGL_SLEEP_LPTIM);
+  __HAL_LPTIM_CLEAR_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_ARROK | LPTIM_FLAG_ARRM);
+  __HAL_LPTIM_AUTORELOAD_SET(&LVGL_SLEEP_LPTIM, counts);
+  while (!__HAL_LPTIM_GET_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_ARROK));
+  __HAL_LPTIM_START_SINGLE(&LVGL_SLEEP_LPTIM);
+}
+
+/* returns the counts slept */
+static uint32_t
+lptim_stop (uint32_t counts)
+{
+  uint32_t cnt;
+
+  /* the counter runs asynchronously, read until stable */
+  do
+    cnt = LVGL_SLEEP_LPTIM.Instance->CNT;
+  while (cnt != LVGL_SLEEP_LPTIM.Instance->CNT);
+
+  /* woken early unless the period completed, the counter is then 0 */
+  if (!__HAL_LPTIM_GET_FLAG(&LVGL_SLEEP_LPTIM, LPTIM_FLAG_ARRM))
+    counts = cnt;
+
+  /* disabling also resets the counter and keeps the flag for the IRQ */
+  LVGL_SLEEP_LPTIM.Instance->CR &= ~LPTIM_CR_ENABLE;
+  return counts;
+}
@@ -0,0 +1,139 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_task.h"
+#include "lvgl_port_tick.h"
+#include "lvgl_port_dma2d.h"
+#include "lvgl_port_display.h"
+#include "lvgl_port_touch.h"
+#include "lvgl_port_ribus.h"
+#include "lvgl_port_image.h"
+#include "lvgl_port_latency.h"
+#include "lvgl_port_worker.h"
+#include "lvgl_port_governor.h"
+#include "lvgl/demos/lv_demos.h"
+#include "cmsis_os2.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+lvgl_task (void *argument);
+
+static void
+lvgl_port_init (void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static osThreadId_t lvgl_thread;
+
+static const osThreadAttr_t lvgl_thread_attr = {
+  .name = "lvglTimer",
+  .priority = (osPriority_t) osPriorityNormal,
+  .stack_size = LVGL_TASK_STACK_SIZE
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_task_create (void)
+{
+  lvgl_thread = osThreadNew(lvgl_task, NULL, &lvgl_thread_attr);
+}
+
+void
+lvgl_task_wake (void)
+{
+  if (lvgl_thread != NULL)
+    osThreadFlagsSet(lvgl_thread, LVGL_TASK_FLAG_WAKE);
+}
+
+void
+lvgl_lock (void)
+{
+  lv_lock();
+}
+
+void
+lvgl_unlock (void)
+{
+  lv_unlock();
+
+  /* let the change show up without waiting for the refresh period */
+  lvgl_task_wake();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+lvgl_task (void *argument)
+{
+  uint32_t wait;
+
+  /* LV_USE_OS creates mutexes and draw threads, so LVGL starts with the
+   * scheduler running */
+  lvgl_port_init();
+
+  for (;;)
+  {
+    /* feed queued touch events to LVGL as soon as they arrive, then draw
+     * the frame due at the last vertical blanking */
+    lv_lock();
+    wait = lvgl_touchscreen_process();
+    wait = LV_MIN(wait, lvgl_display_idle_process());
+    lvgl_display_vsync_process();
+    lv_unlock();
+
+    /* takes the LVGL lock itself, other tasks get it in between */
+    wait = LV_MIN(wait, lv_timer_handler());
+
+    /* sleep until the next LVGL timer is due or something wakes us;
+     * the kernel ticks at 1 kHz so ms and ticks are the same */
+    osThreadFlagsWait(LVGL_TASK_FLAG_WAKE, osFlagsWaitAny,
+                      wait == LV_NO_TIMER_READY ? osWaitForever : wait);
+  }
+}
+
+static void
+lvgl_port_init (void)
+{
+  /* initialize LVGL framework */
+  lv_init();
+
+  /* 1 MHz TIM5 as the LVGL tick */
+  lvgl_tick_init();
+
+  /* DMA2D job queue shared by display flush, overlay and image decoder */
+  lvgl_dma2d_init();
+
+  /* initialize display and touchscreen */
+  lvgl_display_init();
+  lvgl_touchscreen_init();
+
+  /* optional second display on RiBUS */
+  lvgl_ribus_display_init();
+
+  /* DMA2D decoder for palettized images */
+  lvgl_image_init();
+
+  /* touch-to-photon tracer, LVGL_LATENCY_TRACE builds only */
+  lvgl_latency_init();
+
+  /* lower the rendering quality while frames are over budget,
+   * LVGL_GOVERNOR builds only */
+  lvgl_governor_init();
+
+  /* background jobs: image decoding, text layout, data preparation */
+  lvgl_worker_init();
+
+  /* lvgl demo */
+  lv_demo_widgets();
+}
@@ -0,0 +1,125 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_tick.h"
+#include "main.h"
+#include "tim.h"
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static uint32_t
+tick_cb (void);
+
+static uint32_t
+tick_get_ms (void);
+
+static uint32_t
+timer_clock (void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static volatile bool frozen;
+static uint32_t frozen_ms;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_tick_init (void)
+{
+  __HAL_TIM_SET_PRESCALER(&LVGL_TICK_TIM, timer_clock() / 1000000 - 1);
+  __HAL_TIM_SET_COUNTER(&LVGL_TICK_TIM, 0);
+
+  /* load the prescaler now, not at the first overflow */
+  HAL_TIM_GenerateEvent(&LVGL_TICK_TIM, TIM_EVENTSOURCE_UPDATE);
+  HAL_TIM_Base_Start(&LVGL_TICK_TIM);
+
+  lv_tick_set_cb(tick_cb);
+}
+
+uint32_t
+lvgl_tick_get_us (void)
+{
+  return __HAL_TIM_GET_COUNTER(&LVGL_TICK_TIM);
+}
+
+void
+lvgl_tick_add_us (uint32_t us)
+{
+  __HAL_TIM_SET_COUNTER(&LVGL_TICK_TIM, __HAL_TIM_GET_COUNTER(&LVGL_TICK_TIM) + us);
+}
+
+uint32_t
+lvgl_tick_get_ms (void)
+{
+  return tick_get_ms();
+}
+
+void
+lvgl_tick_freeze (uint32_t ms)
+{
+  frozen_ms = ms;
+  frozen = true;
+}
+
+void
+lvgl_tick_thaw (void)
+{
+  frozen = false;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* LVGL tick: the real time unless frozen */
+static uint32_t
+tick_cb (void)
+{
+  return frozen ? frozen_ms : tick_get_ms();
+}
+
+/* ms from the us counter, carrying the remainder so the result wraps at
+ * 2^32 ms like lv_tick_inc(); LVGL reads it every refresh period, far
+ * more often than the ~71 min the counter needs to wrap */
+static uint32_t
+tick_get_ms (void)
+{
+  static uint32_t last_us;
+  static uint32_t rem_us;
+  static uint32_t ms;
+  uint32_t primask = __get_PRIMASK();
+  uint32_t now, us, result;
+
+  __disable_irq();
+
+  now = __HAL_TIM_GET_COUNTER(&LVGL_TICK_TIM);
+  us = now - last_us + rem_us;
+  last_us = now;
+  ms += us / 1000;
+  rem_us = us % 1000;
+  result = ms;
+
+  __set_PRIMASK(primask);
+  return result;
+}
+
+/* APB timers run at twice PCLK unless the APB prescaler is 1 */
+static uint32_t
+timer_clock (void)
+{
+  RCC_ClkInitTypeDef clk;
+  uint32_t latency;
+
+  HAL_RCC_GetClockConfig(&clk, &latency);
+
+  if (clk.APB1CLKDivider == RCC_HCLK_DIV1)
+    return HAL_RCC_GetPCLK1Freq();
+  return HAL_RCC_GetPCLK1Freq() * 2;
+}
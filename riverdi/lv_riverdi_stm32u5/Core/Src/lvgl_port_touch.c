@@ -3,17 +3,60 @@
  *********************/
 
 #include "lvgl_port_touch.h"
+#include "lvgl_port_touch_filter.h"
+#include "lvgl_port_latency.h"
+#include "lvgl_port_record.h"
+#include "lvgl_port_task.h"
 #include "main.h"
 #include "i2c.h"
 
+/*********************
+ *      DEFINES
+ *********************/
+
+#define TOUCH_I2C_ADDR    (0x41 << 1)
+#define TOUCH_REG         0x10
+
+/* must be a power of two */
+#define TOUCH_QUEUE_LEN   16
+
+/* the controller reports every ~10 ms while touched and stays silent on
+ * release: no report for this long means the finger is up */
+#define TOUCH_RELEASE_MS  40
+
+/* LVGL runs long press, scrolling and scroll throw from the reads: read
+ * this often while pressed and until a throw has come to rest */
+#define TOUCH_READ_MS     LV_DEF_REFR_PERIOD
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  int32_t x;
+  int32_t y;
+  uint32_t timestamp;   /* HAL_GetTick() at the controller interrupt */
+} touch_event_t;
+
 /**********************
  *  STATIC VARIABLES
  **********************/
 
-static volatile uint8_t touch_irq = 0;
-static volatile int32_t last_x = 0;
-static volatile int32_t last_y = 0;
-static volatile lv_indev_state_t last_state = LV_INDEV_STATE_RELEASED;
+/* single producer (I2C interrupt), single consumer (LVGL) */
+static touch_event_t queue[TOUCH_QUEUE_LEN];
+static volatile uint32_t q_head;
+static volatile uint32_t q_tail;
+static volatile uint32_t q_dropped;
+
+static lv_indev_t * indev;
+static volatile uint32_t irq_timestamp;
+static volatile bool i2c_error;
+static uint32_t last_timestamp;
+static uint32_t last_read;
+static lv_point_t last_point;
+static bool pressed;
+static uint8_t rx_buf[16];
 
 /**********************
  *  STATIC PROTOTYPES
@@ -22,6 +65,12 @@ static volatile lv_indev_state_t last_state = LV_INDEV_STATE_RELEASED;
 static void
 lvgl_touchscreen_read (lv_indev_t *indev, lv_indev_data_t *data);
 
+static bool
+touch_released (void);
+
+static bool
+touch_busy (void);
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -38,55 +87,168 @@ lvgl_touchscreen_init (void)
   HAL_GPIO_WritePin(CTP_RST_GPIO_Port, CTP_RST_Pin, GPIO_PIN_SET);
   HAL_Delay(10);
 
-  /* basic LVGL driver initialization */
-  lv_indev_t * indev = lv_indev_create();
+  /* basic LVGL driver initialization; read on demand, not by timer */
+  indev = lv_indev_create();
   lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
   lv_indev_set_read_cb(indev, lvgl_touchscreen_read);
+  lv_indev_set_mode(indev, LV_INDEV_MODE_EVENT);
 
 }
 
+/* call from the LVGL thread, before lv_timer_handler(); returns the ms
+ * until it needs to run again without new reports */
+uint32_t
+lvgl_touchscreen_process (void)
+{
+  uint32_t wait = LV_NO_TIMER_READY;
+  uint32_t elapsed;
+
+  if (q_head != q_tail || touch_released() || lvgl_replay_pending() ||
+      (touch_busy() && lv_tick_elaps(last_read) >= TOUCH_READ_MS))
+  {
+    lv_indev_read(indev);
+    last_read = lv_tick_get();
+  }
+
+  if (touch_busy())
+  {
+    elapsed = lv_tick_elaps(last_read);
+    wait = elapsed >= TOUCH_READ_MS ? 0 : TOUCH_READ_MS - elapsed;
+  }
+
+  /* the release is detected by the absence of reports */
+  if (pressed)
+  {
+    elapsed = HAL_GetTick() - last_timestamp;
+    wait = LV_MIN(wait, elapsed > TOUCH_RELEASE_MS ? 0 : TOUCH_RELEASE_MS + 1 - elapsed);
+  }
+
+  return LV_MIN(wait, lvgl_replay_wait());
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+static bool
+touch_released (void)
+{
+  return pressed && (i2c_error || (HAL_GetTick() - last_timestamp) > TOUCH_RELEASE_MS);
+}
+
+static bool
+touch_busy (void)
+{
+  return pressed || lv_indev_get_scroll_obj(indev) != NULL;
+}
+
 static void
 lvgl_touchscreen_read (lv_indev_t      *indev,
                        lv_indev_data_t *data)
 {
-  /*Use the saved coordinates if there were an interrupt*/
-  if(touch_irq)
+  uint32_t tail = q_tail;
+
+  /* the panel is ignored while a recording plays back */
+  if (lvgl_replay_read(data))
+  {
+    q_tail = q_head;
+    pressed = false;
+    return;
+  }
+
+  /* one queued event per call, LVGL calls again while continue_reading */
+  if (tail != q_head)
     {
-      /* reset interrupt flag */
-      touch_irq = 0;
-	  data->point.x = last_x;
-	  data->point.y = last_y;
-	  data->state = last_state;
+      const touch_event_t * ev = &queue[tail & (TOUCH_QUEUE_LEN - 1)];
+      int32_t x = ev->x;
+      int32_t y = ev->y;
+
+      LVGL_LATENCY_MARK(LVGL_LATENCY_READ);
+
+      /* a new touch: forget errors from before it */
+      if (!pressed)
+      {
+        lvgl_touch_filter_reset();
+        i2c_error = false;
+      }
+      lvgl_touch_filter_apply(&x, &y, ev->timestamp);
+
+      last_point.x = x;
+      last_point.y = y;
+      data->point = last_point;
+      data->state = LV_INDEV_STATE_PRESSED;
+      last_timestamp = ev->timestamp;
+      pressed = true;
+
+      __DMB();
+      q_tail = tail + 1;
+      data->continue_reading = (q_tail != q_head);
     }
-    /*If there is no interrupt the touch is released*/
+    /* no report within TOUCH_RELEASE_MS or a failed read: the touch is
+     * released */
+    else if (touch_released()) {
+      pressed = false;
+      i2c_error = false;
+      data->point = last_point;
+      data->state = LV_INDEV_STATE_RELEASED;
+    }
+    /* a periodic read between reports: hold the last state */
     else {
-	  last_state = LV_INDEV_STATE_RELEASED;
-	}
+      data->point = last_point;
+      data->state = pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    }
+
+  lvgl_record_read(data);
 }
 
 void
 HAL_GPIO_EXTI_Falling_Callback(uint16_t GPIO_Pin)
 {
   if (GPIO_Pin == CTP_INT_Pin) {
-	  touch_irq = 1;
-
-	  HAL_StatusTypeDef status;
-	  uint8_t rx_buf[16] = {0};
-	  /* read x/y coordinates */
-	  status = HAL_I2C_Mem_Read(&hi2c1, (0x41 << 1), 0x10, 1, rx_buf, sizeof(rx_buf), 100);
-	  if (status == HAL_OK)
-	  {
-		  last_x = (rx_buf[3] & 0x0F) << 8 | rx_buf[2];
-		  last_y = (rx_buf[5] & 0x0F) << 8 | rx_buf[4];
-		  last_state = LV_INDEV_STATE_PRESSED;
-	  }
-	  else
-	  {
-		  last_state = LV_INDEV_STATE_RELEASED;
-	  }
+	  LVGL_LATENCY_MARK(LVGL_LATENCY_TOUCH);
+
+	  /* start reading x/y coordinates and return; a report arriving while
+	   * the previous read is still running is dropped (HAL_BUSY) */
+	  if (HAL_I2C_Mem_Read_IT(&hi2c1, TOUCH_I2C_ADDR, TOUCH_REG, I2C_MEMADD_SIZE_8BIT,
+	                          rx_buf, sizeof(rx_buf)) == HAL_OK)
+		  irq_timestamp = HAL_GetTick();
+  }
+}
+
+void
+HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
+{
+  uint32_t head = q_head;
+  touch_event_t * ev;
+
+  if (hi2c != &hi2c1)
+	  return;
+
+  if (head - q_tail == TOUCH_QUEUE_LEN)
+  {
+	  q_dropped++;
+	  return;
   }
+
+  ev = &queue[head & (TOUCH_QUEUE_LEN - 1)];
+  ev->x = (rx_buf[3] & 0x0F) << 8 | rx_buf[2];
+  ev->y = (rx_buf[5] & 0x0F) << 8 | rx_buf[4];
+  ev->timestamp = irq_timestamp;
+
+  __DMB();
+  q_head = head + 1;
+
+  lvgl_task_wake();
+}
+
+void
+HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
+{
+  if (hi2c != &hi2c1)
+	  return;
+
+  /* the report is lost: release now instead of waiting for the timeout,
+   * the next interrupt starts a fresh read */
+  i2c_error = true;
+  lvgl_task_wake();
 }
@@ -0,0 +1,160 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_touch_filter.h"
+#include <math.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define PI_F               3.14159265f
+
+/* latency average weight 1/8 */
+#define LATENCY_AVG        8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  float value;      /* filtered position, px */
+  float speed;      /* filtered velocity, px/s */
+} one_euro_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static float
+one_euro (one_euro_t *f, float x, float dt);
+
+static float
+smoothing (float cutoff, float dt);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static bool enabled = LVGL_TOUCH_FILTER;
+static bool started;
+static uint32_t prev_timestamp;
+static one_euro_t fx;
+static one_euro_t fy;
+
+/* written by the LVGL task, read by the flush completion interrupt */
+static volatile uint32_t sample_timestamp;
+static volatile bool sample_pending;
+static volatile uint32_t latency = LVGL_TOUCH_SCANOUT_MS;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_touch_filter_reset (void)
+{
+  started = false;
+}
+
+void
+lvgl_touch_filter_apply (int32_t *x, int32_t *y, uint32_t timestamp)
+{
+  lv_display_t * disp = lv_display_get_default();
+  float dt;
+
+  sample_timestamp = timestamp;
+  sample_pending = true;
+
+  if (!enabled)
+    return;
+
+  if (!started)
+  {
+    fx.value = *x;
+    fy.value = *y;
+    fx.speed = fy.speed = 0.0f;
+    prev_timestamp = timestamp;
+    started = true;
+    return;
+  }
+
+  /* several reports can share a tick when drained from the queue */
+  dt = LV_MAX(timestamp - prev_timestamp, 1) / 1000.0f;
+  prev_timestamp = timestamp;
+
+  one_euro(&fx, *x, dt);
+  one_euro(&fy, *y, dt);
+
+#if LVGL_TOUCH_PREDICT
+  {
+    float horizon = LV_MIN(latency, LVGL_TOUCH_PREDICT_MAX_MS) / 1000.0f;
+
+    *x = lroundf(fx.value + fx.speed * horizon);
+    *y = lroundf(fy.value + fy.speed * horizon);
+  }
+#else
+  *x = lroundf(fx.value);
+  *y = lroundf(fy.value);
+#endif
+
+  *x = LV_CLAMP(0, *x, lv_display_get_horizontal_resolution(disp) - 1);
+  *y = LV_CLAMP(0, *y, lv_display_get_vertical_resolution(disp) - 1);
+}
+
+void
+lvgl_touch_filter_presented (uint32_t now)
+{
+  uint32_t measured;
+
+  /* only the first frame after a sample shows it */
+  if (!sample_pending)
+    return;
+  sample_pending = false;
+
+  measured = now - sample_timestamp + LVGL_TOUCH_SCANOUT_MS;
+  latency = (latency * (LATENCY_AVG - 1) + measured) / LATENCY_AVG;
+}
+
+void
+lvgl_touch_filter_enable (bool enable)
+{
+  enabled = enable;
+  started = false;
+}
+
+uint32_t
+lvgl_touch_filter_get_latency (void)
+{
+  return latency;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static float
+one_euro (one_euro_t *f, float x, float dt)
+{
+  float speed = (x - f->value) / dt;
+  float cutoff;
+
+  f->speed += smoothing(LVGL_TOUCH_D_CUTOFF, dt) * (speed - f->speed);
+
+  /* slow: heavy smoothing against jitter, fast: follow the finger */
+  cutoff = LVGL_TOUCH_MIN_CUTOFF + LVGL_TOUCH_BETA * fabsf(f->speed);
+  f->value += smoothing(cutoff, dt) * (x - f->value);
+
+  return f->value;
+}
+
+/* exponential smoothing factor of a first order low-pass */
+static float
+smoothing (float cutoff, float dt)
+{
+  float tau = 1.0f / (2.0f * PI_F * cutoff);
+
+  return 1.0f / (1.0f + tau / dt);
+}
@@ -0,0 +1,174 @@
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include "lvgl_port_worker.h"
+#include "lvgl_port_task.h"
+#include "cmsis_os2.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct
+{
+  lvgl_worker_cb_t work;
+  lvgl_worker_cb_t done;
+  void * user_data;
+} job_t;
+
+typedef struct
+{
+  const void * src;
+  lv_draw_buf_t * buf;
+  lvgl_worker_image_cb_t done;
+  void * user_data;
+} image_job_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+static void
+worker_task (void *argument);
+
+static void
+image_decode_work (void * user_data);
+
+static void
+image_decode_done (void * user_data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+static osMessageQueueId_t jobs;
+
+static const osThreadAttr_t worker_attr = {
+  .name = "lvglWorker",
+  .priority = (osPriority_t) osPriorityBelowNormal,
+  .stack_size = LVGL_WORKER_STACK_SIZE
+};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void
+lvgl_worker_init (void)
+{
+  uint32_t i;
+
+  jobs = osMessageQueueNew(LVGL_WORKER_QUEUE_LEN, sizeof(job_t), NULL);
+
+  for (i = 0; i < LVGL_WORKER_COUNT; i++)
+    osThreadNew(worker_task, NULL, &worker_attr);
+}
+
+bool
+lvgl_worker_submit (lvgl_worker_cb_t work, lvgl_worker_cb_t done,
+                    void * user_data)
+{
+  job_t job = { work, done, user_data };
+
+  return osMessageQueuePut(jobs, &job, 0, 0) == osOK;
+}
+
+bool
+lvgl_worker_image_decode (const void * src, lvgl_worker_image_cb_t done,
+                          void * user_data)
+{
+  image_job_t * job = lv_malloc(sizeof(image_job_t));
+
+  if (job == NULL)
+    return false;
+
+  job->src = src;
+  job->buf = NULL;
+  job->done = done;
+  job->user_data = user_data;
+
+  if (!lvgl_worker_submit(image_decode_work, image_decode_done, job))
+  {
+    lv_free(job);
+    return false;
+  }
+
+  return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void
+worker_task (void *argument)
+{
+  job_t job;
+
+  for (;;)
+  {
+    if (osMessageQueueGet(jobs, &job, NULL, osWaitForever) != osOK)
+      continue;
+
+    if (job.work)
+      job.work(job.user_data);
+
+    /* lv_async_call() is not thread safe; the unlock wakes the LVGL task */
+    if (job.done)
+      LVGL_LOCKED()
+        lv_async_call(job.done, job.user_data);
+  }
+}
+
+/* only the decoder lookup walks LVGL state and takes the lock; the codec
+ * decodes into the job's own descriptor without it, while the LVGL task
+ * renders. Decoders keep their state in the descriptor, and no_cache
+ * keeps them off the image cache */
+static void
+image_decode_work (void * user_data)
+{
+  image_job_t * job = user_data;
+  lv_image_decoder_t * decoder;
+  lv_image_decoder_dsc_t dsc;
+
+  lv_memzero(&dsc, sizeof(dsc));
+  dsc.src = job->src;
+  dsc.src_type = lv_image_src_get_type(job->src);
+  dsc.args.no_cache = true;
+
+  lv_lock();
+  for (decoder = lv_image_decoder_get_next(NULL); decoder != NULL;
+       decoder = lv_image_decoder_get_next(decoder))
+    if (decoder->info_cb && decoder->open_cb &&
+        decoder->info_cb(decoder, job->src, &dsc.header) == LV_RESULT_OK)
+      break;
+  lv_unlock();
+
+  if (decoder == NULL)
+    return;
+
+  dsc.decoder = decoder;
+  if (decoder->open_cb(decoder, &dsc) != LV_RESULT_OK)
+    return;
+
+  /* the draw buffer is handed over to the LVGL task by image_decode_done */
+  if (dsc.decoded)
+    job->buf = lv_draw_buf_dup(dsc.decoded);
+
+  if (decoder->close_cb)
+    decoder->close_cb(decoder, &dsc);
+}
+
+static void
+image_decode_done (void * user_data)
+{
+  image_job_t * job = user_data;
+
+  if (job->done)
+    job->done(job->buf, job->user_data);
+  else if (job->buf)
+    lv_draw_buf_destroy(job->buf);
+
+  lv_free(job);
+}
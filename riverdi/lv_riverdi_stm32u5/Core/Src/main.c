@@ -47,10 +47,8 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include "lvgl/lvgl.h"
-#include "lvgl/demos/lv_demos.h"
-#include "lvgl_port_touch.h"
-#include "lvgl_port_display.h"
+#include "lvgl_port_sleep.h"
+#include "lvgl_port_heap.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -165,15 +163,13 @@ int main(void)
   /* reset display */
   HAL_GPIO_WritePin(LCD_DISP_RESET_GPIO_Port, LCD_DISP_RESET_Pin, GPIO_PIN_SET);
 
-  /* initialize LVGL framework */
-  lv_init();
+  /* LVGL is initialized by its own task, see lvgl_port_task.c */
 
-  /* initialize display and touchscreen */
-  lvgl_display_init();
-  lvgl_touchscreen_init();
+  /* LPTIM2 wakes the core from tickless idle */
+  lvgl_sleep_init();
 
-  /* lvgl demo */
-  lv_demo_widgets();
+  /* one heap for FreeRTOS and LVGL, before the first pvPortMalloc() */
+  lvgl_heap_init();
 
   /* USER CODE END 2 */
 
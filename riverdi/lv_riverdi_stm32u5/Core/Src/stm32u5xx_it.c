@@ -22,6 +22,8 @@
 #include "stm32u5xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "lvgl_port_sleep.h"
+#include "lvgl_port_ribus.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -61,7 +63,8 @@ extern LTDC_HandleTypeDef hltdc;
 extern TIM_HandleTypeDef htim2;
 
 /* USER CODE BEGIN EV */
-
+extern SPI_HandleTypeDef hspi1;
+extern I2C_HandleTypeDef hi2c1;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -248,4 +251,44 @@ void LTDC_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles SPI1 global interrupt (RiBUS display).
+  */
+void SPI1_IRQHandler(void)
+{
+  HAL_SPI_IRQHandler(&hspi1);
+}
+
+/**
+  * @brief This function handles GPDMA1 channel 7 interrupt (RiBUS display).
+  */
+void GPDMA1_Channel7_IRQHandler(void)
+{
+  lvgl_ribus_dma_irq();
+}
+
+/**
+  * @brief This function handles I2C1 event interrupt (touch controller).
+  */
+void I2C1_EV_IRQHandler(void)
+{
+  HAL_I2C_EV_IRQHandler(&hi2c1);
+}
+
+/**
+  * @brief This function handles I2C1 error interrupt (touch controller).
+  */
+void I2C1_ER_IRQHandler(void)
+{
+  HAL_I2C_ER_IRQHandler(&hi2c1);
+}
+
+/**
+  * @brief This function handles LPTIM2 global interrupt (tickless idle wake-up).
+  */
+void LPTIM2_IRQHandler(void)
+{
+  lvgl_sleep_lptim_irq();
+}
+
 /* USER CODE END 1 */
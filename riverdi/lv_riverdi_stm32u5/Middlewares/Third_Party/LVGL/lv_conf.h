@@ -35,7 +35,7 @@
  * - LV_STDLIB_RTTHREAD:    RT-Thread implementation
  * - LV_STDLIB_CUSTOM:      Implement the functions externally
  */
-#define LV_USE_STDLIB_MALLOC    LV_STDLIB_BUILTIN
+#define LV_USE_STDLIB_MALLOC    LV_STDLIB_CUSTOM   /*lvgl_port_heap.c, shared with FreeRTOS*/
 #define LV_USE_STDLIB_STRING    LV_STDLIB_BUILTIN
 #define LV_USE_STDLIB_SPRINTF   LV_STDLIB_BUILTIN
 
@@ -78,7 +78,7 @@
  * - LV_OS_RTTHREAD
  * - LV_OS_WINDOWS
  * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+#define LV_USE_OS   LV_OS_CMSIS_RTOS2
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -345,7 +345,15 @@
 #define LV_ATTRIBUTE_LARGE_CONST
 
 /*Compiler prefix for a big array declaration in RAM*/
-#define LV_ATTRIBUTE_LARGE_RAM_ARRAY
+/*Zeroed with .bss in SRAM5, named to be found in the map file*/
+#define LV_ATTRIBUTE_LARGE_RAM_ARRAY __attribute__((section(".bss.large_ram")))
+
+/*Prefix variables that are used in GPU accelerated operations, often these need to be placed in RAM sections that are DMA accessible.
+ *Placed in SRAM3, away from the frame buffer in SRAM1 (see STM32U599NJHXQ_FLASH.ld).
+ *Define it empty to compare against a single bank.*/
+#ifndef LV_ATTRIBUTE_DMA
+#define LV_ATTRIBUTE_DMA __attribute__((section(".dma_buffer")))
+#endif
 
 /*Place performance critical functions into a faster memory (e.g RAM)*/
 #define LV_ATTRIBUTE_FAST_MEM
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+#
+# Convert PNG files to palettized C image sources for lvgl_port_image.c
+#
+#   l8   - plain LVGL I8 (256 entry palette + 1 byte per pixel)
+#   l4   - 16 colours, 4 bits per pixel
+#   al44 - 16 colours plus 4-bit alpha per pixel
+#   al88 - 256 colours plus 8-bit alpha per pixel
+#
+# The palette is optimized with Pillow's quantizer (libimagequant when it is
+# available), unused entries are dropped and the rest sorted by frequency.
+#
+# usage: lv_clut_conv.py [-f l8|l4|al44|al88] [-c COLORS] [-o OUT.c] FILE.png...
+#
+# requires Pillow (pip install pillow)
+
+import argparse
+import os
+import re
+import sys
+
+from PIL import Image
+
+FORMATS = {
+    # name: (lvgl_clut_format_t value or None for LVGL I8, max colours, per-pixel alpha)
+    'l8':   (None, 256, False),
+    'l4':   (0x8, 16, False),
+    'al44': (0x6, 16, True),
+    'al88': (0x7, 256, True),
+}
+
+
+def quantize(img, colors, with_alpha):
+    """Return (palette as list of (r, g, b, a), index list)"""
+    if with_alpha:
+        # alpha travels per pixel, the palette only holds colour
+        src = img.convert('RGB')
+        method = Image.Quantize.MEDIANCUT
+    else:
+        src = img
+        method = Image.Quantize.FASTOCTREE
+
+    try:
+        q = src.quantize(colors, method=Image.Quantize.LIBIMAGEQUANT,
+                         dither=Image.Dither.FLOYDSTEINBERG)
+    except (ValueError, OSError):
+        q = src.quantize(colors, method=method,
+                         dither=Image.Dither.FLOYDSTEINBERG)
+
+    if q.palette.mode == 'RGBA':
+        raw = q.getpalette(rawmode='RGBA')
+    else:
+        rgb = q.getpalette()
+        raw = []
+        for i in range(0, len(rgb), 3):
+            raw += rgb[i:i + 3] + [0xFF]
+
+    indices = list(q.getdata())
+
+    # drop unused entries, most frequent first
+    count = {}
+    for i in indices:
+        count[i] = count.get(i, 0) + 1
+    order = sorted(count, key=lambda i: -count[i])
+    remap = {old: new for new, old in enumerate(order)}
+    palette = [tuple(raw[4 * old:4 * old + 4]) for old in order]
+    return palette, [remap[i] for i in indices]
+
+
+def pack(fmt, w, h, indices, alpha):
+    out = bytearray()
+    for y in range(h):
+        row = indices[y * w:(y + 1) * w]
+        arow = alpha[y * w:(y + 1) * w] if alpha else None
+        if fmt == 'l8':
+            out += bytes(row)
+        elif fmt == 'l4':
+            # DMA2D L4: first pixel in the low nibble, lines padded to bytes
+            if w & 1:
+                row = row + [0]
+            for x in range(0, len(row), 2):
+                out.append(row[x] | (row[x + 1] << 4))
+        elif fmt == 'al44':
+            for x in range(w):
+                out.append(((arow[x] >> 4) << 4) | row[x])
+        elif fmt == 'al88':
+            # little endian 16-bit: L in the low byte, A in the high byte
+            for x in range(w):
+                out += bytes((row[x], arow[x]))
+    return out
+
+
+def c_bytes(data, indent='    '):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    return '\n'.join(lines)
+
+
+def convert(path, fmt, colors):
+    container, max_colors, with_alpha = FORMATS[fmt]
+    colors = min(colors or max_colors, max_colors)
+
+    img = Image.open(path).convert('RGBA')
+    w, h = img.size
+    palette, indices = quantize(img, colors, with_alpha)
+    alpha = list(img.getchannel('A').getdata()) if with_alpha else None
+    opaque = all(a == 0xFF for a in (alpha or [p[3] for p in palette]))
+
+    if fmt == 'l8':
+        # LVGL I8 always carries 256 entries
+        palette = palette + [(0, 0, 0, 0xFF)] * (256 - len(palette))
+
+    clut = bytearray()
+    for r, g, b, a in palette:
+        clut += bytes((b, g, r, a))         # lv_color32_t / DMA2D ARGB8888
+
+    pixels = pack(fmt, w, h, indices, alpha)
+    name = re.sub(r'\W', '_', os.path.splitext(os.path.basename(path))[0])
+
+    s = []
+    if container is not None:
+        # lvgl_clut_header_t
+        hdr = bytes((container, 1 if opaque else 0,
+                     len(palette) & 0xFF, len(palette) >> 8))
+        data = hdr + clut + pixels
+        cf, flags, stride = 'LV_COLOR_FORMAT_RAW_ALPHA', 'LVGL_IMAGE_FLAG_CLUT', 0
+        note = '%s, %d colours' % (fmt.upper(), len(palette))
+    else:
+        data = clut + pixels
+        cf, flags, stride = 'LV_COLOR_FORMAT_I8', '0', w
+        note = 'LVGL I8, %d colours used' % len(set(indices))
+
+    s.append('/* %s: %dx%d, %s */' % (os.path.basename(path), w, h, note))
+    s.append('static const uint8_t %s_map[] __attribute__((aligned(4))) = {' % name)
+    s.append(c_bytes(data))
+    s.append('};')
+    s.append('')
+    s.append('const lv_image_dsc_t %s = {' % name)
+    s.append('    .header.magic = LV_IMAGE_HEADER_MAGIC,')
+    s.append('    .header.cf = %s,' % cf)
+    s.append('    .header.flags = %s,' % flags)
+    s.append('    .header.w = %d,' % w)
+    s.append('    .header.h = %d,' % h)
+    s.append('    .header.stride = %d,' % stride)
+    s.append('    .data_size = sizeof(%s_map),' % name)
+    s.append('    .data = %s_map,' % name)
+    s.append('};')
+    s.append('')
+    return '\n'.join(s), len(data), w * h * (2 if opaque else 4)
+
+
+def main():
+    p = argparse.ArgumentParser(description='PNG to DMA2D CLUT image converter')
+    p.add_argument('-f', '--format', choices=FORMATS, default='l8')
+    p.add_argument('-c', '--colors', type=int, default=0,
+                   help='palette size limit (default: format maximum)')
+    p.add_argument('-o', '--output', help='output C file (default: stdout)')
+    p.add_argument('files', nargs='+')
+    args = p.parse_args()
+
+    out = ['#include "lvgl/lvgl.h"', '#include "lvgl_port_image.h"', '']
+    for f in args.files:
+        text, size, expanded = convert(f, args.format, args.colors)
+        out.append(text)
+        print('%s: %d bytes (%d expanded)' % (f, size, expanded), file=sys.stderr)
+
+    text = '\n'.join(out)
+    if args.output:
+        with open(args.output, 'w') as fp:
+            fp.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+if __name__ == '__main__':
+    main()